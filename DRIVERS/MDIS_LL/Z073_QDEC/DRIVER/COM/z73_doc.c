@@ -78,6 +78,87 @@
 	layout of this status word
 	see \ref status_return "section about Z073_STATUS word returned".
 
+	\n \subsubsection queues Status Queues
+	Press/release and gesture entries are placed in a small button queue
+	(descriptor key Z073_BTNQ_SIZE), movement entries in a separate
+	movement queue (Z073_STATUSQ_SIZE). Fast movement therefore can't
+	delay or displace button events. When the movement queue is full, new
+	movement is added to the newest movement entry (or kept pending if the
+	count field would overflow), so movement is never lost. When the
+	button queue is full, new button entries are dropped and counted
+	(getstat Z073_BTNQ_DROPPED), the interrupts stay enabled.
+
+	A press/release entry no longer carries the movement which occurred
+	before it, that movement is reported as a separate Z073_STATUS_MOV
+	entry. The order in which Z073_STATUS returns the entries is set with
+	the Z073_QORDER SetStat or descriptor key:
+	- Z073_QORDER_SEQ: order of occurrence across both queues (default)
+	- Z073_QORDER_PRIO: all button entries first
+
+	The block getstat Z073_BLK_EVENTS reads several entries with one call.
+	Each Z73_EVENT contains the status word, the OSS tick of the event and
+	a sequence number giving the order of occurrence. A coalesced movement
+	entry gets the tick and a new sequence number of its last part.
+
+	The depth of both queues can be changed at runtime with the SetStats
+	Z073_STATUSQ_SIZE and Z073_BTNQ_SIZE. Queued entries are kept; the
+	SetStat fails with ERR_LL_ILL_PARAM if they don't fit into the new
+	depth.
+
+	With Z073_STATUSQ_MAX set, the movement queue adapts to the load: when
+	its fill level came close to the depth, it is doubled up to
+	Z073_STATUSQ_MAX entries, after Z073_STATUSQ_QUIET ms without reaching
+	half of Z073_STATUSQ_SIZE it shrinks back to Z073_STATUSQ_SIZE. Memory
+	can't be allocated in interrupt context, so the buffer for the next
+	grow step is allocated ahead whenever the application enters the
+	driver. The interrupt side takes it as soon as the fill level comes
+	close to the depth, also while the application does not read. A
+	stalled application therefore gets one grow step; after that the full
+	queue coalesces movement as above until the driver is called again.
+
+	All queue depths, including Z073_STATUSQ_MAX, are limited to 65536
+	entries; larger values are rejected with ERR_LL_ILL_PARAM.
+
+	With descriptor key Z073_STATUSQ_COMPACT set, the movement queue stores
+	delta records instead of Z73_EVENT entries: a movement following the
+	previous entry directly is stored in 2 bytes (8 bit count delta, input
+	levels and 5 bit tick delta). Other entries, larger deltas and every
+	64th record (keyframe) are stored as full 13 byte record. Entries are
+	expanded when they are read. Z073_STATUSQ_SIZE still gives the number
+	of entries (2 bytes each). In this mode every move interrupt queues an
+	entry, so the queue keeps the movement history while the application
+	does not read; when it is full, the movement is carried and reported
+	with the next entry.
+
+	\n \subsubsection reset Reset
+	The SetStat Z073_RESET starts a new measurement, or recovers from an
+	error, without close/open and without reallocating queues or signals.
+	With the interrupt masked once, it
+	- discards the counts not yet reported,
+	- flushes the queues and drops a gesture in progress
+	  (Z073_RESET_FLUSH) or keeps the queued entries,
+	- sets the position to 0 (Z073_RESET_POS), the block SetStat
+	  Z073_BLK_RESET sets it to Z73_RESET.pos instead,
+	- clears pending interrupts and the error state and
+	- enables the configured interrupt causes again.
+
+	Other flags are rejected with ERR_LL_ILL_PARAM, nothing is reset then.
+
+	\n \subsubsection read_ch Using M_read()
+	M_read() provides read-only channels which can be sampled at any time
+	without removing entries from the status queue:
+	- Z073_CH_POS: accumulated position, including the live position counter
+	- Z073_CH_INPUTS: current PRESS_N/A/B input levels (coded as
+	  Z073_STATUS_PRESS_N/INPUT_A/INPUT_B)
+	- Z073_CH_QFILL: number of entries in the status queue
+
+	Counts read from the hardware by M_read() are not lost, they are reported
+	with the next Z073_STATUS entry.
+
+	Since the channels are read-only, the M_LL_CH_DIR GetStat returns
+	M_CH_IN. Older driver versions returned M_CH_OUT, so the M_LL_CH_DIR
+	SetStat accepts both M_CH_IN and M_CH_OUT for compatibility.
+
 	\n \section interrupts Interrupts
 	The driver supports interrupts from the FPGA. The M-Modules interrupt
 	can be enabled/disabled through the M_MK_IRQ_ENABLE SetStat code or the
@@ -85,12 +166,322 @@
 	and Z073_INT_REL enable/disable the single interrupt causes. The same effect
 	can be achieved through the corresponding descriptor entries.
 
+	\n \subsection deferred Deferred Interrupt Processing
+	With the descriptor key Z073_DEFERRED set, the interrupt service routine
+	only reads and acknowledges the interrupt register and stores the
+	snapshot. Decoding, queuing, gesture recognition and signalling are done
+	by an OSS alarm outside of the interrupt (on Linux in timer context).
+	This keeps the time the (shared) interrupt line is held short.
+
+	The cost is latency: OSS has no tasklet or workqueue hook, and the
+	1 ms one-shot alarm is rounded up to the timer tick, so each burst of
+	interrupts is processed up to one tick later (10 ms at 100 Hz, 1 ms
+	at 1000 Hz). Use it only where this latency is acceptable. When the
+	snapshot buffer is full, the ISR processes the oldest snapshot itself,
+	so no event is lost or reordered.
+
+	\n \subsection irq_demand Demand Driven Interrupts
+	With Z073_IRQ_DEMAND (descriptor key or setstat) set to a budget of
+	unread entries, the interrupt causes are only enabled in hardware
+	when somebody uses them: while a caller waits in Z073_WAIT, while a
+	signal is installed, or while gesture recognition, raw edge capture or
+	interval summaries are on. Otherwise button events are taken until
+	the budget of unread entries is reached. Movement is only taken when
+	the ISR queues it (Z073_STATUSQ_COMPACT); otherwise it is
+	read from the position counter when the status is read. The state is
+	checked whenever the driver is entered and after each interrupt.
+	Events of disabled causes stay pending in the interrupt register. They
+	are reported by the next status read, or they fire as soon as the
+	cause is enabled again, so a new waiter is woken at once.
+
+	While disabled, several presses between two reads count as one. The
+	position counter must be read (any status read or Z073_CH_POS) before
+	it overflows, or the watchdog must be on (see \ref wdog).
+
+	\n \subsection wdog Wrap Protection Watchdog
+	Without move interrupts (polled operation, Z073_IRQ_DEMAND) the
+	position counter is only read when the application reads the status.
+	If the axis moves more than the range of Z073_POS_CNT in between, the
+	counts wrap and the position is wrong. With Z073_WDOG (descriptor key
+	or setstat) set to a max. period in ms, an OSS alarm reads the counter
+	in the background. The counts go to the accumulated position and to
+	the delta pending for the next status entry, the watchdog queues no
+	entries and sends no signals. A pending delta larger than the count
+	field of the Z073_STATUS word is reported in several entries.
+
+	The period adapts to the speed: it is halved while the position
+	moved by more than 1/4 of the counter range since the last run and
+	doubled while it moved by less than 1/8, between Z073_WDOG_MIN
+	(default 10 ms) and Z073_WDOG. A still axis costs one register read
+	per max. period. Getstat Z073_WDOG_PERIOD returns the current period.
+	The min. period limits the speed: with 10 ms and the 16 bit counter
+	the period is kept safe up to about 800,000 counts/s, the counter
+	wraps beyond about 3,200,000 counts/s.
+
 	\n \section signals Signals
 	The driver can send signals to notify the application of changes on the
 	signal lines . The signal must be activated via the Z73_SIG_PRS_REL and
 	Z073_SIG_MOVE SetStat codes and can be cleared by the same code and passing
 	0 as argument.
 
+	\n \subsection sig_modes Notification Modes
+	By default a signal is sent for every interrupt. The Z073_SIG_MODE
+	SetStat (or descriptor key) selects a coalescing mode instead:
+	- Z073_SIGMODE_EVERY: a signal for every event (default)
+	- Z073_SIGMODE_EDGE: one signal per signal type, further events are not
+	  signalled until the application has read the status queue empty
+	  (Z073_STATUS returned Z073_ERR_NO_STATUS or the last entry)
+	- Z073_SIGMODE_WATERMARK: as Z073_SIGMODE_EDGE, but the signal is held
+	  back until the status queue holds at least Z073_SIG_WATERMARK entries.
+	  Coalesced movements and entries already read don't count.
+
+	With Z073_SIG_MAXLAT set, a held back signal is sent at the latest
+	Z073_SIG_MAXLAT milliseconds after the first unreported event.
+
+	\n \subsection evt_sigs Event Signals
+	OSS signals carry no data, so Z073_SIG_EVENT installs a range of
+	Z073_EVTSIG_NUM signals starting at the given signal number instead.
+	Each press, release, move up/down and gesture event sends its own
+	signal (base + Z073_EVTSIG_xxx), independent of the notification mode.
+	On Linux, realtime signals are queued, so the handler receives one
+	signal per event in order and can act without calling
+	M_getstat(Z073_STATUS).
+
+	With Z073_SIG_EVENT_NOQ set, press/release and gesture events delivered
+	by event signals are not placed in the status queue. Movement is still
+	queued because the position delta can't be delivered by a signal.
+
+	\n \section waiting Waiting for Events
+	A device is ready when status entries are queued, a move interrupt was
+	not yet reported or an error is pending. The Z073_WAIT GetStat blocks
+	until the device is ready (or Z073_WAIT_TOUT expired) and returns the
+	number of queued entries. Z073_WAIT_TOUT is shared by all paths of the
+	device, so callers with their own timeout use Z073_BLK_WAIT, which
+	takes the timeout with the call (Z73_WAIT).
+
+	For event loops, the Z073_SIG_READY signal is sent once when the device
+	becomes ready. It is re-armed when Z073_STATUS has read the queue
+	empty. The z73_api library uses it to wait on several paths with one
+	call (Z73_WaitSetCreate()/Z73_WaitSetWait()); the application passes
+	the signal numbers. On Linux the signals are received through a
+	signalfd; its descriptor (Z73_WaitSetFd()) works with poll(), select()
+	and epoll. Elsewhere the library blocks in UOS_SigWait(), or in
+	Z073_BLK_WAIT when the wait set has only one path.
+
+	The driver does not request call locking from MDIS (LL_LOCK_NONE), so a
+	thread blocked in Z073_WAIT does not delay other threads using the same
+	device. Several threads may wait at the same time, all of them are
+	woken when the device becomes ready.
+
+	\n \section gestures Gesture Recognition
+	When the descriptor key Z073_GEST_ENABLE is set, the driver derives
+	gestures from the press/release interrupts (which are enabled
+	automatically) and OSS alarms:
+	- Z073_GEST_CLICK: button pressed and released
+	- Z073_GEST_DBLCLICK: second click within Z073_GEST_DBLCLICK ms
+	- Z073_GEST_LONG_START/Z073_GEST_LONG_END: button held for more than
+	  Z073_GEST_LONG ms and released again
+	- Z073_GEST_REPEAT: every Z073_GEST_REPEAT ms while held after
+	  Z073_GEST_LONG_START
+
+	Gestures are placed in the status queue with Z073_STATUS_GEST set and
+	the gesture code in Z073_STATUS_GEST_CODE. The raw press/release entries
+	are still queued. The signal installed with Z073_SIG_GESTURE is sent
+	once per gesture. A value of 0 disables the double click, long press or
+	repeat detection respectively; without double click detection a click
+	is reported immediately at release.
+
+	\n \section trace Binary Trace
+	When built with the switch Z73_TRACE, the driver records the ISR, the
+	deferred processing, queue and signal activity as compact binary
+	records (id, timestamp, sequence number, two values, see
+	\ref trace_ids "trace record ids") in a ring of Z73_TRC_DEPTH records
+	per device. Recording costs a few stores with the interrupt masked
+	already, no formatting is done, so the timing of the driver stays
+	nearly unchanged. The oldest records are overwritten when the ring is
+	full, gaps in the sequence numbers show this.
+
+	The records are read (and removed) with the block getstat
+	Z073_BLK_TRACE. The tool z73_trace writes them to a file, which is
+	decoded on the host with z73_trcdec. Without Z73_TRACE the trace
+	macros compile to nothing and Z073_BLK_TRACE returns ERR_LL_ILL_FUNC.
+
+	\n \section mmio Register Access Log and Replay
+	When built with the switch Z73_MMIO_LOG, every register access goes
+	through a logging wrapper and each entry into the driver (ISR, alarm
+	routines, Read/GetStat/SetStat calls incl. the first
+	Z073_MMIO_DATA_MAX bytes of block data) is recorded as Z73_MMIO_REC
+	(see \ref mmio_types "record types") in a ring of Z73_MMIO_DEPTH
+	records per device. Each record carries the id of the calling task
+	(OSS_GetPid()); a SetStat call is logged after it got the
+	configuration semaphore, i.e. in the order the calls were serialized. Logging starts at driver init with a
+	Z073_MMIO_START record. When the ring is full new records are
+	dropped and counted, so the log must be read continuously:
+	"z73_trace -m -f" reads it with the block getstat Z073_BLK_MMIO and
+	writes it to a file. Without Z73_MMIO_LOG the wrappers are plain
+	register accesses and Z073_BLK_MMIO returns ERR_LL_ILL_FUNC.
+
+	The host tool z73_replay includes the unmodified driver source with
+	OSS and descriptor replacements and replays the log: the recorded
+	calls are invoked in the recorded order, register reads return the
+	recorded values and the recorded time is returned as tick count. Each
+	recorded task calls the driver from its own host thread, the log
+	decides when the threads are switched, so calls of several tasks
+	overlap as on the target; a semaphore wait which blocked on the target
+	runs the following interrupts, alarms and calls of other tasks until
+	it is signaled or its own task continues (timeout). The
+	replay runs as fast as possible or at the recorded speed multiplied by
+	a factor. It reports the host time per path (ISR, alarm, each status
+	code), the fill and overflows of the status queues, and every access
+	which differs from the log. Descriptor keys of the target which
+	change the register accesses must be given to z73_replay (-d).
+
+	\n \section capture Raw Edge Capture
+	Setting Z073_CAPTURE to a ring depth (2..65536 records, 0 switches off)
+	makes the ISR store one Z73_CAP_REC per interrupt: timestamp, the raw
+	IRQ register (levels of the A, B and push button inputs, see
+	\ref cap_irq_bits "capture IRQ bits"), the signed count delta of the
+	position counter since the previous record and a sequence number. The
+	oldest records are overwritten when the ring is full. The records are
+	read (and removed) with the block getstat Z073_BLK_CAPTURE.
+
+	The tool z73_capture enables the move interrupts, writes the records
+	to a file and z73_capdec decodes it on the host: it reconstructs the
+	x4 position from the A/B levels, compares it with the hardware counts
+	and reports illegal transitions, lost records and the edge rate
+	distribution; edges within the same timestamp count as fastest rate.
+
+	On x86 and PowerPC the timestamp is taken from the CPU cycle counter
+	(TSC, time base), scaled down to roughly 1 MHz. Its rate is measured
+	against the system tick at open and returned by Z073_TS_RATE, the
+	tools write it into the file header. Other CPUs use OSS_TickGet().
+	Z73_TIMESTAMP and Z73_TIMESTAMP_RATE can be overridden at build time
+	with another source.
+
+	\n \section summary Interval Summaries
+	For trend displays and logging the driver reduces the events to one
+	summary per interval: net counts, position at the end, min./max.
+	position, number of presses and releases and the peak velocity
+	(Z73_SUMMARY). The interval is set with Z073_SUM_INTERVAL (descriptor
+	key or setstat, in ms, rounded to the OSS tick, 0 switches off) and
+	intervals start at multiples of its length. Count changes are read in
+	the ISR while summaries are on, so each change goes to the interval in
+	which it occurred. Intervals without activity have no summary.
+
+	Completed summaries are read (and removed) with the block getstat
+	Z073_BLK_SUMMARY. The driver keeps Z073_SUM_DEPTH summaries, the
+	oldest is overwritten when nobody reads them (gap in
+	Z73_SUMMARY.seq). The status queues are not affected. Longer intervals
+	are built by merging summaries: add delta, presses and releases and
+	take the extremes of the other fields.
+
+	\n \section warm Warm Start
+	Normally the position starts at 0 with every open of the device and
+	counts of the hardware counter from before are discarded. With the
+	descriptor key Z073_WARM_START the driver stores the position and the
+	A/B input levels when the device is closed (Z73_Exit()) and restores
+	them at the next open: the counts the hardware accumulated in between
+	are added, so no homing is needed as long as the encoder was not moved
+	unobserved. The value of the key is the id of the checkpoint (0 is
+	off), it must differ between the devices using the warm start: the
+	address of a device may change from one open to the next, the id
+	doesn't. Opening a device with an id already used by another open
+	device fails (ERR_LL_ILL_PARAM). The checkpoints are kept in the
+	driver module (8 ids) and survive close/open, not an unload of the
+	driver or a power cycle.
+
+	The checkpoint is checked against the quadrature phase of the A/B
+	inputs: the phase must have advanced by the counts since the
+	checkpoint (x4 counting), otherwise it is rejected and the position
+	starts at 0. This detects a lost counter content but not a movement
+	by a multiple of four counts, e.g. a counter overflow (more than the
+	count width while closed). Z073_WARM_STATE tells if the position was
+	restored (Z073_WARM_xxx).
+
+	To survive a driver reload or a reboot without power loss, the
+	application reads a checkpoint with the block getstat
+	Z073_BLK_CHECKPOINT (Z73_CHECKPOINT), keeps it e.g. in a file and
+	restores it after the next open with the block setstat of the same
+	code, which applies the same check (Z073_ERR_CKPT_MISMATCH). Like
+	a position reset, a restored checkpoint closes the current summary
+	interval and restarts the watchdog from the restored position.
+
+	\n \section extrap Position Extrapolation
+	Every change of the position counter is stored with its timestamp in a
+	short history (the last 8 changes). The block getstat
+	Z073_BLK_POS_EXTRAP returns the position at a target time, which is
+	either given in Z73_POS_EXTRAP.target (Z073_EXTRAP_AT, same time base
+	as Z73_POS_EXTRAP.now) or the time of the call (Z073_EXTRAP_NOW). The
+	block is passed in both directions. Other modes are rejected with
+	ERR_LL_ILL_PARAM.
+
+	The counter is read at the call, so the position up to now is exact.
+	A target in the past is interpolated between the stored changes, a
+	target in the future is extrapolated with the mean velocity of the
+	newest changes, limited to a horizon of the length of the sample
+	window (Z073_EXTRAP_CLAMPED). When no count arrived for more than two
+	count intervals of that velocity, the encoder is taken as stationary
+	(Z073_EXTRAP_STILL) and the velocity is 0. The confidence
+	(0..Z073_EXTRAP_CONF_MAX) is the maximum for observed positions and
+	decreases with fewer samples, a longer horizon and a change of
+	direction. The timestamps are most accurate with the move interrupts
+	enabled, otherwise a count change is timestamped when the counter is
+	read.
+
+	The times use the timestamp of the \ref capture "raw edge capture".
+	With the cycle counter (x86, PowerPC) single count intervals are
+	resolved; on other CPUs the system tick is used, several count changes
+	then share one timestamp and the velocity is only known as an average
+	over the window. Z73_POS_EXTRAP.tickRate tells the resolution.
+
+	\n \section cpp C++ Client Library
+	The header only library MEN/z73.hpp (C++17) wraps the consumer side:
+	z73::Device is an RAII path with batched reads (Z073_BLK_EVENTS) into
+	decoded z73::Event objects (kind, sign extended count, gesture code,
+	tick, sequence number). z73::Reader runs a thread which waits with
+	Z073_BLK_WAIT (timeout per call, the device setting Z073_WAIT_TOUT is
+	not touched) and feeds a lock-free single producer/single consumer queue,
+	or calls a callback for each event. With C++20 coroutines the next
+	event can be awaited:
+
+	\code
+	z73::Device dev( "z73_1" );
+	z73::Reader rd( dev );
+	dev.setstat( Z073_INT_UP, 1 );
+	dev.setstat( Z073_INT_DWN, 1 );
+	dev.enable( true );
+
+	while( auto ev = co_await rd.next() )
+	    pos += ev->count();
+	\endcode
+
+	Events which don't fit into the queue are counted by
+	z73::Reader::dropped(), status queue overflows of the driver by
+	z73::Device::overruns(). An MDIS error or an exception thrown by the
+	callback stops the reader thread and is kept in
+	z73::Reader::exception(); waiting consumers are woken. stop() waits at
+	most the poll time of the reader for the thread.
+
+	The example z73_bench measures events per second, events per wake up,
+	CPU time per event and the losses of each stage for a plain wait/read
+	loop, the queue and the callback mode while the encoder is turned.
+	z73_bench -s measures the lock-free queue alone.
+
+	\n \section shmd Shared Memory Daemon
+	The status queue of a device has one consumer. When several local
+	processes need the encoder state, the daemon z73_shmd owns the paths
+	of up to 8 devices and publishes them in a POSIX shared memory segment
+	(default /z73_shm, layout see z73_shm.h). It waits on all paths with a
+	wait set, drains the events in batches and writes them to one slot per
+	device: the current state (position, last status, heartbeat, overflow
+	count) and a ring of the newest 256 events.
+
+	Each slot is protected by a seqlock. Readers map the segment read-only
+	with Z73_ShmOpen() of the z73_api library and copy the state with
+	Z73_ShmState() or new events with Z73_ShmEvents(). They make no system
+	call and never block the daemon; a reader which falls behind by more
+	than the ring size loses the oldest events and is told how many.
+
 	\n \section api_functions Supported API Functions
 
 	<table border="0">
@@ -103,7 +494,7 @@
 
 	<tr><td>M_close()     </td><td>Close device             </td>
 	<td>Z73_Exit())</td></tr>
-	<tr><td>M_read()      </td><td>not supported by driver  </td>
+	<tr><td>M_read()      </td><td>Read position/input/queue channels</td>
 	<td>Z73_Read()</td></tr>
 	<tr><td>M_write()     </td><td>not supported by driver  </td>
 	<td>Z73_Write()</td></tr>
@@ -146,6 +537,87 @@
 		<td>enable button (counter) moved down interrupt</td>
 		<td>0..1, default: 0</td>
 	</tr>
+	<tr><td>Z073_STATUSQ_SIZE</td>
+		<td>number of entries in movement queue</td>
+		<td>2..65536, default: 10</td>
+	</tr>
+	<tr><td>Z073_STATUSQ_COMPACT</td>
+		<td>store movement queue as delta records</td>
+		<td>0..1, default: 0</td>
+	</tr>
+	<tr><td>Z073_STATUSQ_MAX</td>
+		<td>max. depth of adaptive movement queue, 0 = not adaptive</td>
+		<td>0..65536, default: 0</td>
+	</tr>
+	<tr><td>Z073_STATUSQ_QUIET</td>
+		<td>quiet time [ms] before adaptive movement queue shrinks</td>
+		<td>0..n, default: 10000</td>
+	</tr>
+	<tr><td>Z073_BTNQ_SIZE</td>
+		<td>number of entries in button (press/release/gesture) queue</td>
+		<td>2..65536, default: 8</td>
+	</tr>
+	<tr><td>Z073_QORDER</td>
+		<td>read order of the status queues</td>
+		<td>0..1, default: 0 (Z073_QORDER_SEQ)</td>
+	</tr>
+	<tr><td>Z073_IRQ_DEMAND</td>
+		<td>demand driven interrupts: unread entries budget, 0 = off</td>
+		<td>0..n, default: 0</td>
+	</tr>
+	<tr><td>Z073_WDOG</td>
+		<td>wrap protection watchdog: max. period [ms], 0 = off</td>
+		<td>0..n, default: 0</td>
+	</tr>
+	<tr><td>Z073_WDOG_MIN</td>
+		<td>min. period of the wrap protection watchdog [ms]</td>
+		<td>1..n, default: 10</td>
+	</tr>
+	<tr><td>Z073_DEFERRED</td>
+		<td>process interrupts outside of the ISR</td>
+		<td>0..1, default: 0</td>
+	</tr>
+	<tr><td>Z073_SIG_MODE</td>
+		<td>signal notification mode</td>
+		<td>0..2, default: 0 (Z073_SIGMODE_EVERY)</td>
+	</tr>
+	<tr><td>Z073_SIG_WATERMARK</td>
+		<td>queue fill to reach before signalling (Z073_SIGMODE_WATERMARK)</td>
+		<td>1..n, default: 1</td>
+	</tr>
+	<tr><td>Z073_SIG_MAXLAT</td>
+		<td>max. latency of a held back signal [ms], 0 = unlimited</td>
+		<td>0..n, default: 0</td>
+	</tr>
+	<tr><td>Z073_GEST_ENABLE</td>
+		<td>enable gesture recognition</td>
+		<td>0..1, default: 0</td>
+	</tr>
+	<tr><td>Z073_GEST_LONG</td>
+		<td>long press time [ms], 0 = off</td>
+		<td>0..n, default: 500</td>
+	</tr>
+	<tr><td>Z073_GEST_DBLCLICK</td>
+		<td>double click window [ms], 0 = off</td>
+		<td>0..n, default: 300</td>
+	</tr>
+	<tr><td>Z073_GEST_REPEAT</td>
+		<td>auto repeat period during long press [ms], 0 = off</td>
+		<td>0..n, default: 0</td>
+	</tr>
+	<tr><td>Z073_SUM_INTERVAL</td>
+		<td>interval of the summaries [ms], 0 = off</td>
+		<td>0..n, default: 0</td>
+	</tr>
+	<tr><td>Z073_SUM_DEPTH</td>
+		<td>number of completed summaries kept</td>
+		<td>2..n, default: 64</td>
+	</tr>
+	<tr><td>Z073_WARM_START</td>
+		<td>keep the position from close to the next open, checkpoint
+			id unique per device</td>
+		<td>0=off, else id, default: 0</td>
+	</tr>
 	</table>
 
 
@@ -156,6 +628,24 @@
 
 	\subsection z73_simp  Simple example for using the driver
 	z73_simp.c (see example section)
+
+	\subsection z73_api  User library
+	z73_api.c: wait on several Z73 paths, read the z73_shmd segment
+
+	\subsection z73_shmd  Shared memory daemon
+	z73_shmd.c: publish state and events of several devices (Linux)
+
+	\subsection z73_hpp  C++ client library
+	z73.hpp: RAII device, decoded events, background reader (header only)
+
+	\subsection z73_trace  Trace tools
+	z73_trace.c: dump the trace ring to a file (target) \n
+	z73_trcdec.c: decode a trace file (host) \n
+	z73_replay.c: replay a register access log on the host (z73_trace -m)
+
+	\subsection z73_capture  Capture tools
+	z73_capture.c: capture raw encoder edges to a file (target) \n
+	z73_capdec.c: decode a capture file (host)
 */
 
 /** \example z73_simp.c
@@ -45,6 +45,14 @@
     #endif
 #endif
 
+/*-----------------------------------------+
+|  GLOBALS                                 |
++-----------------------------------------*/
+/** checkpoints by Z073_WARM_START id, the address of a device may change
+ *  from one open to the next. Z73_Init() and Z73_Exit() are serialized by
+ *  the MDIS kernel. */
+static Z73_CKPT G_ckpt[Z73_CKPT_NUM];
+
 /****************************** Z73_GetEntry ********************************/
 /** Initialize driver's jump table
  *
@@ -193,36 +201,241 @@ static int32 Z73_Init(
         error != ERR_DESC_KEY_NOTFOUND)
         return( Cleanup(llHdl,error) );
 
-    llHdl->statusQDepth  = (value > 1) ? value : Z073_STATUSQ_SIZE_DEF;
+    llHdl->movQ.depth = (value > 1) ? value : Z073_STATUSQ_SIZE_DEF;
+
+    if ((error = DESC_GetUInt32(llHdl->descHdl, Z073_BTNQ_SIZE_DEF,
+                                &value, "Z073_BTNQ_SIZE")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    llHdl->btnQ.depth = (value > 1) ? value : Z073_BTNQ_SIZE_DEF;
+
+    if( llHdl->movQ.depth > Z73_Q_MAX || llHdl->btnQ.depth > Z73_Q_MAX )
+        return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+    /* compact movement queue */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+                                &llHdl->movQ.compact, "Z073_STATUSQ_COMPACT")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    /* adaptive movement queue */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+                                &llHdl->qAdaptMax, "Z073_STATUSQ_MAX")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if( llHdl->qAdaptMax > Z73_Q_MAX )
+        return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+    if ((error = DESC_GetUInt32(llHdl->descHdl, Z073_STATUSQ_QUIET_DEF,
+                                &llHdl->qAdaptQuiet, "Z073_STATUSQ_QUIET")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if ((error = DESC_GetUInt32(llHdl->descHdl, Z073_QORDER_SEQ,
+                                &llHdl->qOrder, "Z073_QORDER")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if( llHdl->qOrder > Z073_QORDER_PRIO )
+        return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+    /* gesture recognition */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+                                &llHdl->gestEn, "Z073_GEST_ENABLE")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if ((error = DESC_GetUInt32(llHdl->descHdl, Z073_GEST_LONG_DEF,
+                                &llHdl->gestLongMs, "Z073_GEST_LONG")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if ((error = DESC_GetUInt32(llHdl->descHdl, Z073_GEST_DBLCLICK_DEF,
+                                &llHdl->gestDblMs, "Z073_GEST_DBLCLICK")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if ((error = DESC_GetUInt32(llHdl->descHdl, Z073_GEST_REPEAT_DEF,
+                                &llHdl->gestRepMs, "Z073_GEST_REPEAT")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    /* deferred interrupt processing. OSS offers no tasklet/workqueue
+     * hook, so the snapshots are processed by a one-shot alarm. Its 1 ms
+     * are rounded up to the timer tick: every burst of interrupts is
+     * delayed by up to one tick (10 ms at 100 Hz). */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+                                &llHdl->deferred, "Z073_DEFERRED")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    /* signal notification */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, Z073_SIGMODE_EVERY,
+                                &llHdl->sigMode, "Z073_SIG_MODE")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if( llHdl->sigMode > Z073_SIGMODE_WATERMARK )
+        return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 1,
+                                &llHdl->sigWatermark, "Z073_SIG_WATERMARK")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+                                &llHdl->sigMaxLat, "Z073_SIG_MAXLAT")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    /* warm start */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+                                &llHdl->warmStart, "Z073_WARM_START")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    /* demand driven interrupts */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+                                &llHdl->irqDemand, "Z073_IRQ_DEMAND")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    /* interval summaries */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+                                &llHdl->sumIntv, "Z073_SUM_INTERVAL")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if ((error = DESC_GetUInt32(llHdl->descHdl, Z73_SUM_DEPTH_DEF,
+                                &llHdl->sumDepth, "Z073_SUM_DEPTH")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if( llHdl->sumDepth < 2 )
+        return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+    /* wrap protection watchdog */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+                                &llHdl->wdogMax, "Z073_WDOG")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if ((error = DESC_GetUInt32(llHdl->descHdl, Z73_WDOG_MIN_DEF,
+                                &llHdl->wdogMin, "Z073_WDOG_MIN")) &&
+        error != ERR_DESC_KEY_NOTFOUND)
+        return( Cleanup(llHdl,error) );
+
+    if( llHdl->wdogMin < 1 )
+        return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+    llHdl->waitTout = OSS_SEM_WAITFOREVER;
 
     DBGWRT_1((DBH, "LL - Z73_Init base addr = 0x%08x\n", llHdl->ma));
 
 
 
     /*------------------------------+
-    |  init status queue            |
+    |  init status queues           |
     +------------------------------*/
+    if ((error = qAlloc(llHdl, &llHdl->btnQ, llHdl->btnQ.depth)) ||
+        (error = qAlloc(llHdl, &llHdl->movQ, llHdl->movQ.depth)))
+        return( Cleanup(llHdl,error) );
 
-    if ((llHdl->statusQ = (u_int32 *)OSS_MemGet(
-                    osHdl, 4*llHdl->statusQDepth, &gotsize)) == NULL)
-    {
-        error = ERR_OSS_MEM_ALLOC;
+    llHdl->movQBase = Z73_Q_DEPTH( &llHdl->movQ );
+
+    DBGWRT_1((DBH, "LL - Z73_Init btnQ depth=%d movQ depth=%d\n",
+            (int)llHdl->btnQ.depth, (int)llHdl->movQ.depth));
+
+#ifdef Z73_TRACE
+    /*------------------------------+
+    |  init trace ring              |
+    +------------------------------*/
+    if ((llHdl->trc = (Z73_TRC_REC*)OSS_MemGet(
+                    osHdl, Z73_TRC_DEPTH * sizeof(Z73_TRC_REC), &gotsize)) == NULL)
+        return( Cleanup(llHdl,ERR_OSS_MEM_ALLOC) );
+    llHdl->trcSizeGot = gotsize;
+#endif
+
+#ifdef Z73_TS_CYCLES
+    /*------------------------------+
+    |  calibrate timestamp source   |
+    +------------------------------*/
+    llHdl->tsRate = tsCalibrate( llHdl );
+    DBGWRT_1((DBH, "LL - Z73_Init timestamp rate=%d\n", llHdl->tsRate));
+#endif
+
+#ifdef Z73_MMIO_LOG
+    /*------------------------------+
+    |  init register access log     |
+    +------------------------------*/
+    if ((llHdl->mmio = (Z73_MMIO_REC*)OSS_MemGet(
+                    osHdl, Z73_MMIO_DEPTH * sizeof(Z73_MMIO_REC),
+                    &gotsize)) == NULL)
+        return( Cleanup(llHdl,ERR_OSS_MEM_ALLOC) );
+    llHdl->mmioSizeGot = gotsize;
+    Z73_MMIO_EV( llHdl, Z073_MMIO_START, Z73_TIMESTAMP_RATE( llHdl ) );
+#endif
+
+    /*------------------------------+
+    |  init signal notification     |
+    +------------------------------*/
+    if ((error = OSS_AlarmCreate(osHdl, sigLatAlarm, llHdl,
+                                 &llHdl->sigLatAlarm)))
         return( Cleanup(llHdl,error) );
-    }
-    llHdl->statusQSizeGot = gotsize;
-    DBGWRT_1((DBH, "LL - Z73_Init statusQ=0x%08x size=%d\n",
-            (u_int32 *)llHdl->statusQ, (int)llHdl->statusQSizeGot));
 
-    /* clear */
-    OSS_MemFill(osHdl, gotsize, (char*)llHdl->statusQ, 0x00);
+    if ((error = OSS_SemCreate(osHdl, OSS_SEM_BIN, 0, &llHdl->readySem)))
+        return( Cleanup(llHdl,error) );
+
+    if ((error = OSS_SemCreate(osHdl, OSS_SEM_BIN, 1, &llHdl->cfgSem)))
+        return( Cleanup(llHdl,error) );
+
+    if ((error = OSS_AlarmCreate(osHdl, wdogAlarm, llHdl,
+                                 &llHdl->wdogAlarm)))
+        return( Cleanup(llHdl,error) );
+
+    if ((error = OSS_AlarmCreate(osHdl, qGrowAlarm, llHdl,
+                                 &llHdl->qGrowAlarm)))
+        return( Cleanup(llHdl,error) );
+    qSpareGet( llHdl );
+
+    if( llHdl->deferred &&
+        (error = OSS_AlarmCreate(osHdl, deferProcess, llHdl,
+                                 &llHdl->deferAlarm)))
+        return( Cleanup(llHdl,error) );
+
+    /*------------------------------+
+    |  init gesture recognition     |
+    +------------------------------*/
+    if( llHdl->gestEn )
+    {
+        if ((error = OSS_AlarmCreate(osHdl, gestureAlarm, llHdl,
+                                     &llHdl->gestAlarm)))
+            return( Cleanup(llHdl,error) );
+
+        /* gestures are derived from the press/release interrupts */
+        llHdl->irqEn |= Z073_IRQ_EN_PRS | Z073_IRQ_EN_REL;
+        llHdl->gestState = Z73_GEST_IDLE;
+    }
 
     /*------------------------------+
     |  init hardware                |
     +------------------------------*/
-    /* clear and enable interrupts and position status */
-    MWRITE_D32( ma, Z073_IRQ_EN, 0x00 );
-    MREAD_D32( ma, Z073_POS_CNT );
-    MWRITE_D32( ma, Z073_IRQ, 0xFFFFFFFF );
+    /* clear and enable interrupts and position status (or take over the
+     * position with warm start) */
+    Z73_WR( llHdl, Z073_IRQ_EN, 0x00 );
+    if( (error = warmRestore( llHdl )) )
+        return( Cleanup(llHdl,error) );
+    Z73_WR( llHdl, Z073_IRQ, 0xFFFFFFFF );
+
+    /* summaries start with the (restored) position */
+    if( llHdl->sumIntv &&
+        (error = sumEnable( llHdl, llHdl->sumIntv )) )
+        return( Cleanup(llHdl,error) );
+
+    if( llHdl->wdogMax )
+        wdogSet( llHdl, llHdl->wdogMax );
 
     *llHdlP = llHdl;    /* set low-level driver handle */
 
@@ -233,7 +446,8 @@ static int32 Z73_Init(
 /** De-initialize hardware and clean up memory
  *
  *  The function deinitializes all channels by setting them to ???.
- *  The interrupt is disabled.
+ *  The interrupt is disabled. With Z073_WARM_START the position is kept
+ *  for the next Z73_Init() of the device.
  *
  *  \param llHdlP      \IN  pointer to low-level driver handle
  *
@@ -252,7 +466,13 @@ static int32 Z73_Exit(
     |  de-init hardware             |
     +------------------------------*/
     /* disable interrupts */
-    MWRITE_D32( llHdl->ma, Z073_IRQ_EN, 0x00 );
+    Z73_WR( llHdl, Z073_IRQ_EN, 0x00 );
+
+    /* no counter reads behind the checkpoint */
+    wdogSet( llHdl, 0 );
+
+    if( llHdl->warmStart )
+        warmSave( llHdl );
 
     /*------------------------------+
     |  clean up memory              |
@@ -264,9 +484,26 @@ static int32 Z73_Exit(
 }
 
 /****************************** Z73_Read ************************************/
-/** Read a value from the device, not supported by this driver
+/** Read a value from the device
  *
- *  \return           \c ERR_LL_ILL_FUNC
+ *  The following \ref read_channels "channels" are supported:
+ *
+ * \code
+ *  Channel          Value
+ *  ---------------  ---------------------------------------------
+ *  Z073_CH_POS      accumulated position (incl. live Z073_POS_CNT)
+ *  Z073_CH_INPUTS   current PRESS_N/A/B input levels
+ *  Z073_CH_QFILL    number of entries in status queue
+ * \endcode
+ *
+ *  None of the channels removes entries from the status queue. Counts read
+ *  from the hardware are kept and reported with the next Z073_STATUS entry.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param ch         \IN  current channel
+ *  \param valueP     \OUT read value
+ *
+ *  \return           \c 0 on success or error code
  */
 static int32 Z73_Read(
     LL_HANDLE *llHdl,
@@ -274,7 +511,37 @@ static int32 Z73_Read(
     int32 *valueP
 )
 {
-    return(ERR_LL_ILL_FUNC);
+    OSS_IRQ_STATE irqState;
+    int32 error = ERR_SUCCESS;
+
+    Z73_MMIO_API( llHdl, Z073_MMIO_READ, ch, 0 );
+
+    switch( ch )
+    {
+        case Z073_CH_POS:
+            irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+            readPosCnt( llHdl );
+            *valueP = llHdl->posAcc;
+            OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+            break;
+        case Z073_CH_INPUTS:
+            *valueP = (int32)((Z73_RD( llHdl, Z073_IRQ ) &
+                               (Z073_IRQ_STS_PRSREL | Z073_IRQ_STS_B |
+                                Z073_IRQ_STS_A)) << 24);
+            break;
+        case Z073_CH_QFILL:
+            irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+            *valueP = (int32)Z73_STATUSQ_FILL( llHdl );
+            OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+            break;
+        default:
+            error = ERR_LL_ILL_CHAN;
+    }
+
+    if( !error )
+        DBGWRT_2((DBH, "LL - Z73_Read: ch=%d value=0x%08x\n", ch, *valueP));
+
+    return(error);
 }
 
 /****************************** Z73_Write ***********************************/
@@ -319,6 +586,14 @@ static int32 Z73_SetStat(
     DBGWRT_1((DBH, "LL - Z73_SetStat: ch=%d code=0x%04x value=0x%x\n",
               ch,code,value));
 
+    /* configuration changes are serialized, readers are not blocked */
+    if( (error = OSS_SemWait( llHdl->osHdl, llHdl->cfgSem,
+                              OSS_SEM_WAITFOREVER )) )
+        return( error );
+
+    /* logged in the order the calls are serialized */
+    Z73_MMIO_API( llHdl, Z073_MMIO_SETSTAT, code, value32_or_64 );
+
     switch(code)
     {
         /*--------------------------+
@@ -331,16 +606,25 @@ static int32 Z73_SetStat(
         |  enable interrupts        |
         +--------------------------*/
         case M_MK_IRQ_ENABLE:
+        {
+            OSS_IRQ_STATE irqState;
+
+            irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
             if( value ) /* enable interrupts ?*/
             {
-                MREAD_D32( llHdl->ma, Z073_POS_CNT );
-                MWRITE_D32( llHdl->ma, Z073_IRQ, 0xFFFFFFFF );
-                MWRITE_D32( llHdl->ma, Z073_IRQ_EN, llHdl->irqEn );
-            } else       /* disable interrupts */
-            {
-                MWRITE_D32( llHdl->ma, Z073_IRQ_EN, 0 );
+                /* discard counts not yet reported, keep position */
+                readPosCnt( llHdl );
+                llHdl->posPending = 0;
+                llHdl->posMoved   = FALSE;
+                llHdl->moveIrq    = FALSE;
+
+                Z73_WR( llHdl, Z073_IRQ, 0xFFFFFFFF );
             }
+            llHdl->irqOn = value ? TRUE : FALSE;
+            irqArm( llHdl );
+            OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
             break;
+        }
         /*--------------------------+
         |  set irq counter          |
         +--------------------------*/
@@ -351,7 +635,9 @@ static int32 Z73_SetStat(
         |  channel direction        |
         +--------------------------*/
         case M_LL_CH_DIR:
-            if( value != M_CH_OUT )
+            /* the channels are read-only (M_CH_IN), M_CH_OUT as reported
+             * by older driver versions is still accepted */
+            if( value != M_CH_IN && value != M_CH_OUT )
                 error = ERR_LL_ILL_DIR;
             break;
         case Z073_SIG_PRS_REL:
@@ -394,135 +680,323 @@ static int32 Z73_SetStat(
                 error = OSS_SigRemove( llHdl->osHdl, &llHdl->upDwnSig );
             }
             break;
-        case Z073_INT_PRS:
-            if( value && !(llHdl->irqEn & Z073_IRQ_EN_PRS) )
-            {  /* enable interrupt */
-                llHdl->irqEn |= Z073_IRQ_EN_PRS;
-                if( (MREAD_D32( llHdl->ma, Z073_IRQ_EN ) & Z073_IRQ_EN_ALL) )
-                { /* only enable irqs if already enabled */
-                    MWRITE_D32( llHdl->ma, Z073_IRQ, Z073_IRQ_PRS );
-                    MWRITE_D32( llHdl->ma, Z073_IRQ_EN, llHdl->irqEn );
+        case Z073_SIG_GESTURE:
+            if( value ) /* install signal */
+            {   /* signal already installed ? */
+                if( llHdl->gestSig ) {
+                    error = ERR_OSS_SIG_SET;
+                    break;
                 }
-            } else if( !value )  /* disable interrupt */
+
+                error = OSS_SigCreate( llHdl->osHdl, value, &llHdl->gestSig );
+            } else /* clear signal */
             {
-                llHdl->irqEn &= ~Z073_IRQ_EN_PRS;
-                MWRITE_D32( llHdl->ma, Z073_IRQ_EN, llHdl->irqEn );
-            }
-            break;
-        case Z073_INT_REL:
-            if( value && !(llHdl->irqEn & Z073_IRQ_EN_REL) )
-            {  /* enable interrupt */
-                llHdl->irqEn |= Z073_IRQ_EN_REL;
-                if( (MREAD_D32( llHdl->ma, Z073_IRQ_EN ) & Z073_IRQ_EN_ALL) )
-                { /* only enable irqs if already enabled */
-                    MWRITE_D32( llHdl->ma, Z073_IRQ, Z073_IRQ_REL );
-                    MWRITE_D32( llHdl->ma, Z073_IRQ_EN, llHdl->irqEn );
+                /* signal already installed ? */
+                if( llHdl->gestSig == NULL ) {
+                    error = ERR_OSS_SIG_CLR;
+                    break;
                 }
-            } else if( !value )  /* disable interrupt */
-            {
-                llHdl->irqEn &= ~Z073_IRQ_EN_REL;
-                MWRITE_D32( llHdl->ma, Z073_IRQ_EN, llHdl->irqEn );
+
+                error = OSS_SigRemove( llHdl->osHdl, &llHdl->gestSig );
             }
             break;
-        case Z073_INT_UP:
-            if( value && !(llHdl->irqEn & Z073_IRQ_EN_UP) )
-            {  /* enable interrupt */
-                llHdl->irqEn |= Z073_IRQ_EN_UP;
-                if( (MREAD_D32( llHdl->ma, Z073_IRQ_EN ) & Z073_IRQ_EN_ALL) )
-                { /* only enable irqs if already enabled */
-                    MWRITE_D32( llHdl->ma, Z073_IRQ, Z073_IRQ_UP );
-                    MWRITE_D32( llHdl->ma, Z073_IRQ_EN, llHdl->irqEn );
+        case Z073_SIG_READY:
+            if( value ) /* install signal */
+            {   /* signal already installed ? */
+                if( llHdl->readySig ) {
+                    error = ERR_OSS_SIG_SET;
+                    break;
                 }
-            } else if( !value )  /* disable interrupt */
+
+                error = OSS_SigCreate( llHdl->osHdl, value, &llHdl->readySig );
+            } else /* clear signal */
             {
-                llHdl->irqEn &= ~Z073_IRQ_EN_UP;
-                MWRITE_D32( llHdl->ma, Z073_IRQ_EN, llHdl->irqEn );
-            }
-            break;
-        case Z073_INT_DWN:
-            if( value && !(llHdl->irqEn & Z073_IRQ_EN_DWN) )
-            {  /* enable interrupt */
-                llHdl->irqEn |= Z073_IRQ_EN_DWN;
-                if( (MREAD_D32( llHdl->ma, Z073_IRQ_EN ) & Z073_IRQ_EN_ALL) )
-                { /* only enable irqs if already enabled */
-                    MWRITE_D32( llHdl->ma, Z073_IRQ, Z073_IRQ_DWN );
-                    MWRITE_D32( llHdl->ma, Z073_IRQ_EN, llHdl->irqEn );
+                /* signal already installed ? */
+                if( llHdl->readySig == NULL ) {
+                    error = ERR_OSS_SIG_CLR;
+                    break;
                 }
-            } else if( !value )  /* disable interrupt */
-            {
-                llHdl->irqEn &= ~Z073_IRQ_EN_DWN;
-                MWRITE_D32( llHdl->ma, Z073_IRQ_EN, llHdl->irqEn );
+
+                error = OSS_SigRemove( llHdl->osHdl, &llHdl->readySig );
             }
             break;
-       /*--------------------------+
-        |  (unknown)                |
-        +--------------------------*/
-        default:
-            error = ERR_LL_UNK_CODE;
-    }
-
-    return(error);
-}
+        case Z073_WAIT_TOUT:
+            llHdl->waitTout = value;
+            break;
+        case Z073_SIG_EVENT:
+        {
+            int32 i;
 
-/****************************** Z73_GetStat *********************************/
-/** Get the driver status
- *
- *  The driver supports \ref getstat_setstat_codes "these status codes"
- *  in addition to the standard codes (see mdis_api.h).
- *
- *  \param llHdl            \IN  low-level handle
- *  \param code             \IN  \ref getstat_setstat_codes "status code"
- *  \param ch               \IN  current channel
- *  \param value32_or_64P   \IN  pointer to block data structure (M_SG_BLOCK) for
- *                               block status codes
- *  \param value32_or_64P   \OUT data pointer or pointer to block data structure
- *                               (M_SG_BLOCK) for block status codes
- *
- *  \return           \c ERR_SUCCESS on success or error code
- */
-static int32 Z73_GetStat(
-    LL_HANDLE *llHdl,
-    int32  code,
-    int32  ch,
-    INT32_OR_64 *value32_or_64P
-)
-{
-    /* pointer to 32bit value  */
-    int32       *valueP       = (int32*)value32_or_64P;
-    /* stores 32/64bit pointer  */
-    INT32_OR_64 *value64P     = value32_or_64P;
-    /*   stores block struct pointer */
-    /* M_SG_BLOCK   *blk          = (M_SG_BLOCK*)value32_or_64P;*/
-    int32 error = ERR_SUCCESS;
+            if( value ) /* install signals */
+            {   /* signals already installed ? */
+                if( llHdl->evtSig[0] ) {
+                    error = ERR_OSS_SIG_SET;
+                    break;
+                }
 
-    DBGWRT_1((DBH, "LL - Z73_GetStat: ch=%d code=0x%04x\n",
-              ch,code));
+                for( i=0; i<Z073_EVTSIG_NUM && !error; i++ )
+                    error = OSS_SigCreate( llHdl->osHdl, value + i,
+                                           &llHdl->evtSig[i] );
+                if( error )
+                    evtSigRemove( llHdl );
+            } else /* clear signals */
+            {
+                /* signals already installed ? */
+                if( llHdl->evtSig[0] == NULL ) {
+                    error = ERR_OSS_SIG_CLR;
+                    break;
+                }
 
-    switch(code)
-    {
+                evtSigRemove( llHdl );
+            }
+            break;
+        }
+        case Z073_SIG_EVENT_NOQ:
+            llHdl->evtSigNoQ = value;
+            break;
         /*--------------------------+
-        |  debug level              |
+        |  status queue read order  |
         +--------------------------*/
-        case M_LL_DEBUG_LEVEL:
-            *valueP = llHdl->dbgLevel;
+        case Z073_QORDER:
+            if( value < Z073_QORDER_SEQ || value > Z073_QORDER_PRIO )
+                error = ERR_LL_ILL_PARAM;
+            else
+                llHdl->qOrder = value;
             break;
         /*--------------------------+
-        |  number of channels       |
+        |  status queue depth       |
         +--------------------------*/
-        case M_LL_CH_NUMBER:
-            *valueP = CH_NUMBER;
+        case Z073_STATUSQ_SIZE:
+            if( value < 2 || value > Z73_Q_MAX )
+                error = ERR_LL_ILL_PARAM;
+            else if( !(error = qResize( llHdl, &llHdl->movQ, value )) )
+            {
+                llHdl->movQBase = value;
+                qSpareGet( llHdl );
+            }
+            break;
+        case Z073_BTNQ_SIZE:
+            if( value < 2 || value > Z73_Q_MAX )
+                error = ERR_LL_ILL_PARAM;
+            else
+                error = qResize( llHdl, &llHdl->btnQ, value );
+            break;
+        case Z073_STATUSQ_MAX:
+            if( value < 0 || value > Z73_Q_MAX )
+                error = ERR_LL_ILL_PARAM;
+            else
+            {
+                llHdl->qAdaptMax = value;
+                qSpareGet( llHdl );
+            }
+            break;
+        case Z073_STATUSQ_QUIET:
+            llHdl->qAdaptQuiet = value;
             break;
         /*--------------------------+
-        |  channel direction        |
+        |  raw edge capture         |
         +--------------------------*/
-        case M_LL_CH_DIR:
-            *valueP = M_CH_OUT;
+        case Z073_CAPTURE:
+            if( value < 0 || value == 1 || value > Z73_CAP_MAX )
+                error = ERR_LL_ILL_PARAM;
+            else
+                error = capEnable( llHdl, value );
             break;
         /*--------------------------+
-        |  channel length [bits]    |
+        |  interval summaries       |
         +--------------------------*/
-        case M_LL_CH_LEN:
-            *valueP = 32;
+        case Z073_SUM_INTERVAL:
+            if( value < 0 )
+                error = ERR_LL_ILL_PARAM;
+            else
+                error = sumEnable( llHdl, (u_int32)value );
+            break;
+        /*--------------------------+
+        |  demand driven interrupts |
+        +--------------------------*/
+        case Z073_IRQ_DEMAND:
+            if( value < 0 )
+                error = ERR_LL_ILL_PARAM;
+            else
+                llHdl->irqDemand = value;
+            break;
+        /*--------------------------+
+        |  wrap protection watchdog |
+        +--------------------------*/
+        case Z073_WDOG:
+            if( value < 0 )
+                error = ERR_LL_ILL_PARAM;
+            else
+                wdogSet( llHdl, (u_int32)value );
+            break;
+        /*--------------------------+
+        |  reset                    |
+        +--------------------------*/
+        case Z073_RESET:
+            error = devReset( llHdl, (u_int32)value, 0 );
+            break;
+        case Z073_BLK_RESET:
+        {
+            M_SG_BLOCK *blk = (M_SG_BLOCK*)value32_or_64;
+            Z73_RESET *rst = (Z73_RESET*)blk->data;
+
+            if( blk->size < (int32)sizeof(Z73_RESET) )
+                error = ERR_LL_USERBUF;
+            else
+                error = devReset( llHdl, rst->flags, rst->pos );
+            break;
+        }
+        /*--------------------------+
+        |  restore checkpoint       |
+        +--------------------------*/
+        case Z073_BLK_CHECKPOINT:
+        {
+            M_SG_BLOCK *blk = (M_SG_BLOCK*)value32_or_64;
+            Z73_CHECKPOINT *cp = (Z73_CHECKPOINT*)blk->data;
+            OSS_IRQ_STATE irqState;
+
+            if( blk->size < (int32)sizeof(Z73_CHECKPOINT) )
+                error = ERR_LL_USERBUF;
+            else if( cp->magic != Z073_CKPT_MAGIC ||
+                     cp->version != Z073_CKPT_VERSION )
+                error = ERR_LL_ILL_PARAM;
+            else
+            {
+                irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+                readPosCnt( llHdl );
+                error = ckptApply( llHdl, cp->pos, cp->inputs );
+                OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+            }
+            break;
+        }
+        /*--------------------------+
+        |  signal notification      |
+        +--------------------------*/
+        case Z073_SIG_MODE:
+        case Z073_SIG_WATERMARK:
+        case Z073_SIG_MAXLAT:
+        {
+            OSS_IRQ_STATE irqState;
+
+            if( (code == Z073_SIG_MODE &&
+                 (value < Z073_SIGMODE_EVERY || value > Z073_SIGMODE_WATERMARK)) ||
+                (code == Z073_SIG_WATERMARK && value < 1) ||
+                (code == Z073_SIG_MAXLAT && value < 0) )
+            {
+                error = ERR_LL_ILL_PARAM;
+                break;
+            }
+
+            irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+            /* don't lose signals held back under the old settings */
+            sigSendPending( llHdl );
+            if( code == Z073_SIG_MODE )
+                llHdl->sigMode = value;
+            else if( code == Z073_SIG_WATERMARK )
+                llHdl->sigWatermark = value;
+            else
+                llHdl->sigMaxLat = value;
+            sigRearm( llHdl );
+            OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+            break;
+        }
+        /*--------------------------+
+        |  single interrupt causes  |
+        +--------------------------*/
+        case Z073_INT_PRS:
+            irqCauseEnable( llHdl, Z073_IRQ_EN_PRS, Z073_IRQ_PRS, value );
+            break;
+        case Z073_INT_REL:
+            irqCauseEnable( llHdl, Z073_IRQ_EN_REL, Z073_IRQ_REL, value );
+            break;
+        case Z073_INT_UP:
+            irqCauseEnable( llHdl, Z073_IRQ_EN_UP, Z073_IRQ_UP, value );
+            break;
+        case Z073_INT_DWN:
+            irqCauseEnable( llHdl, Z073_IRQ_EN_DWN, Z073_IRQ_DWN, value );
+            break;
+       /*--------------------------+
+        |  (unknown)                |
+        +--------------------------*/
+        default:
+            error = ERR_LL_UNK_CODE;
+    }
+
+    /* causes, signals or the budget may have changed */
+    {
+        OSS_IRQ_STATE irqState;
+
+        irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+        irqArm( llHdl );
+        OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+    }
+
+    OSS_SemSignal( llHdl->osHdl, llHdl->cfgSem );
+
+    return(error);
+}
+
+/****************************** Z73_GetStat *********************************/
+/** Get the driver status
+ *
+ *  The driver supports \ref getstat_setstat_codes "these status codes"
+ *  in addition to the standard codes (see mdis_api.h).
+ *
+ *  \param llHdl            \IN  low-level handle
+ *  \param code             \IN  \ref getstat_setstat_codes "status code"
+ *  \param ch               \IN  current channel
+ *  \param value32_or_64P   \IN  pointer to block data structure (M_SG_BLOCK) for
+ *                               block status codes
+ *  \param value32_or_64P   \OUT data pointer or pointer to block data structure
+ *                               (M_SG_BLOCK) for block status codes
+ *
+ *  \return           \c ERR_SUCCESS on success or error code
+ */
+static int32 Z73_GetStat(
+    LL_HANDLE *llHdl,
+    int32  code,
+    int32  ch,
+    INT32_OR_64 *value32_or_64P
+)
+{
+    /* pointer to 32bit value  */
+    int32       *valueP       = (int32*)value32_or_64P;
+    /* stores 32/64bit pointer  */
+    INT32_OR_64 *value64P     = value32_or_64P;
+    /*   stores block struct pointer */
+    M_SG_BLOCK   *blk          = (M_SG_BLOCK*)value32_or_64P;
+    int32 error = ERR_SUCCESS;
+
+    DBGWRT_1((DBH, "LL - Z73_GetStat: ch=%d code=0x%04x\n",
+              ch,code));
+
+    Z73_MMIO_API( llHdl, Z073_MMIO_GETSTAT, code, value32_or_64P );
+
+    switch(code)
+    {
+        /*--------------------------+
+        |  debug level              |
+        +--------------------------*/
+        case M_LL_DEBUG_LEVEL:
+            *valueP = llHdl->dbgLevel;
+            break;
+        /*--------------------------+
+        |  number of channels       |
+        +--------------------------*/
+        case M_LL_CH_NUMBER:
+            *valueP = CH_NUMBER;
+            break;
+        /*--------------------------+
+        |  channel direction        |
+        +--------------------------*/
+        case M_LL_CH_DIR:
+            *valueP = M_CH_IN;  /* was M_CH_OUT before the read channels */
+            break;
+        /*--------------------------+
+        |  channel length [bits]    |
+        +--------------------------*/
+        case M_LL_CH_LEN:
+            *valueP = 32;
             break;
         /*--------------------------+
         |  channel type info        |
@@ -544,41 +1018,289 @@ static int32 Z73_GetStat(
             *value64P = (INT32_OR_64)&llHdl->idFuncTbl;
             break;
         /*--------------------------+
+        |  signal notification      |
+        +--------------------------*/
+        case Z073_SIG_MODE:
+            *valueP = llHdl->sigMode;
+            break;
+        case Z073_SIG_WATERMARK:
+            *valueP = llHdl->sigWatermark;
+            break;
+        case Z073_SIG_MAXLAT:
+            *valueP = llHdl->sigMaxLat;
+            break;
+        /*--------------------------+
+        |  wait for status          |
+        +--------------------------*/
+        case Z073_WAIT:
+        {
+            u_int32 fill = 0;
+
+            error = waitReady( llHdl, llHdl->waitTout, &fill );
+            *valueP = (int32)fill;
+            break;
+        }
+        case Z073_BLK_WAIT:
+        {
+            Z73_WAIT *w = (Z73_WAIT*)blk->data;
+
+            if( blk->size < (int32)sizeof(Z73_WAIT) )
+                error = ERR_LL_USERBUF;
+            else
+            {
+                error = waitReady( llHdl, w->tout, &w->fill );
+                blk->size = sizeof(Z73_WAIT);
+            }
+            break;
+        }
+        case Z073_WAIT_TOUT:
+            *valueP = llHdl->waitTout;
+            break;
+        case Z073_SIG_EVENT_NOQ:
+            *valueP = llHdl->evtSigNoQ;
+            break;
+        case Z073_QORDER:
+            *valueP = llHdl->qOrder;
+            break;
+        case Z073_STATUSQ_SIZE:
+            *valueP = Z73_Q_DEPTH( &llHdl->movQ );
+            break;
+        case Z073_BTNQ_SIZE:
+            *valueP = Z73_Q_DEPTH( &llHdl->btnQ );
+            break;
+        case Z073_BTNQ_DROPPED:
+            *valueP = llHdl->btnDropped;
+            break;
+        case Z073_STATUSQ_MAX:
+            *valueP = llHdl->qAdaptMax;
+            break;
+        case Z073_STATUSQ_QUIET:
+            *valueP = llHdl->qAdaptQuiet;
+            break;
+        case Z073_CAPTURE:
+            *valueP = llHdl->capDepth;
+            break;
+        case Z073_TS_RATE:
+            *valueP = Z73_TIMESTAMP_RATE( llHdl );
+            break;
+        case Z073_SUM_INTERVAL:
+            *valueP = llHdl->sumIntv;
+            break;
+        case Z073_IRQ_DEMAND:
+            *valueP = llHdl->irqDemand;
+            break;
+        case Z073_WDOG:
+            *valueP = llHdl->wdogMax;
+            break;
+        case Z073_WDOG_PERIOD:
+            *valueP = llHdl->wdogMax ? llHdl->wdogMs : 0;
+            break;
+        /*--------------------------+
+        |   capture records         |
+        +--------------------------*/
+        case Z073_BLK_CAPTURE:
+        {
+            OSS_IRQ_STATE irqState;
+            Z73_CAP_REC *dst = (Z73_CAP_REC*)blk->data;
+            u_int32 n = 0, max = (u_int32)blk->size / sizeof(Z73_CAP_REC);
+
+            irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+            if( !llHdl->cap )
+                error = ERR_LL_ILL_FUNC;
+
+            while( !error && n < max && llHdl->capOut != llHdl->capIn )
+            {
+                dst[n++] = llHdl->cap[llHdl->capOut];
+                llHdl->capOut = (llHdl->capOut + 1) % llHdl->capDepth;
+            }
+            OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+
+            blk->size = n * sizeof(Z73_CAP_REC);
+            break;
+        }
+        /*--------------------------+
+        |   interval summaries      |
+        +--------------------------*/
+        case Z073_BLK_SUMMARY:
+        {
+            OSS_IRQ_STATE irqState;
+            Z73_SUMMARY *dst = (Z73_SUMMARY*)blk->data;
+            u_int32 n = 0, max = (u_int32)blk->size / sizeof(Z73_SUMMARY);
+
+            irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+            if( !llHdl->sum )
+                error = ERR_LL_ILL_FUNC;
+            else
+                sumClose( llHdl, OSS_TickGet( llHdl->osHdl ) );
+
+            while( !error && n < max && llHdl->sumOut != llHdl->sumIn )
+            {
+                dst[n++] = llHdl->sum[llHdl->sumOut];
+                llHdl->sumOut = (llHdl->sumOut + 1) % llHdl->sumDepth;
+            }
+            OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+
+            blk->size = n * sizeof(Z73_SUMMARY);
+            break;
+        }
+        /*--------------------------+
+        |   warm start              |
+        +--------------------------*/
+        case Z073_WARM_STATE:
+            *valueP = llHdl->warmState;
+            break;
+        case Z073_BLK_CHECKPOINT:
+        {
+            Z73_CHECKPOINT *cp = (Z73_CHECKPOINT*)blk->data;
+            OSS_IRQ_STATE irqState;
+
+            if( blk->size < (int32)sizeof(Z73_CHECKPOINT) )
+            {
+                error = ERR_LL_USERBUF;
+                break;
+            }
+
+            irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+            readPosCnt( llHdl );
+            cp->pos    = llHdl->posAcc;
+            cp->inputs = Z73_RD( llHdl, Z073_IRQ ) &
+                         (Z073_IRQ_STS_PRSREL | Z073_IRQ_STS_A |
+                          Z073_IRQ_STS_B);
+            OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+
+            cp->magic   = Z073_CKPT_MAGIC;
+            cp->version = Z073_CKPT_VERSION;
+            cp->tick    = OSS_TickGet( llHdl->osHdl );
+            blk->size   = sizeof(Z73_CHECKPOINT);
+            break;
+        }
+        /*--------------------------+
+        |   position extrapolation  |
+        +--------------------------*/
+        case Z073_BLK_POS_EXTRAP:
+            if( blk->size < (int32)sizeof(Z73_POS_EXTRAP) )
+                error = ERR_LL_USERBUF;
+            else if( ((Z73_POS_EXTRAP*)blk->data)->mode != Z073_EXTRAP_AT &&
+                     ((Z73_POS_EXTRAP*)blk->data)->mode != Z073_EXTRAP_NOW )
+                error = ERR_LL_ILL_PARAM;
+            else
+                posExtrap( llHdl, (Z73_POS_EXTRAP*)blk->data );
+            break;
+        /*--------------------------+
         |   get status              |
         +--------------------------*/
         case Z073_STATUS:
         {
             OSS_IRQ_STATE irqState;
+            Z73_EVENT ev;
             *valueP = 0; /* in case off error return value might be parsed */
 
-            if( llHdl->error ) /* errors have higher priority than data */
+            /* emptiness test and dequeue in one masked region,
+             * the interrupt can't queue in between */
+            irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+
+            if( Z73_STATUSQ_EMPTY( llHdl ) ) /* empty queues */
+                getStatus( llHdl, 0 );
+
+            if( statusGet( llHdl, &ev ) )
+                *valueP = (int32)ev.status;
+            else
+                error = Z073_ERR_NO_STATUS;
+
+            Z73_TRC( llHdl, Z073_TRC_GETSTATUS, error ? error : *valueP,
+                     Z73_STATUSQ_FILL( llHdl ) );
+
+            /* queues read completely, allow new signals */
+            if( Z73_STATUSQ_EMPTY( llHdl ) )
+                sigRearm( llHdl );
+            irqArm( llHdl );
+            OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+
+            if( error )
             {
-                error = llHdl->error;
-                llHdl->error = 0;
-                DBGWRT_ERR((DBH, "*** LL - Z73_GetStat(STATUS): 0x%04x\n", error));
-                break;
+                DBGWRT_3((DBH, "LL - Z73_GetStat(STATUS): no new events\n"));
             }
 
-            if( llHdl->statusQIn == llHdl->statusQOut ) /* empty queue */
-            {
-                irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
-                error  = getStatus( llHdl );
-                OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+            qAdapt( llHdl );
+            break;
+        }
+        /*--------------------------+
+        |   get several entries     |
+        +--------------------------*/
+        case Z073_BLK_EVENTS:
+        {
+            OSS_IRQ_STATE irqState;
+            Z73_EVENT *dst = (Z73_EVENT*)blk->data;
+            u_int32 n = 0, max = (u_int32)blk->size / sizeof(Z73_EVENT);
 
-                if( llHdl->statusQIn == llHdl->statusQOut ) /* still empty */
-                {
-                    error = Z073_ERR_NO_STATUS;
-                    DBGWRT_3((DBH, "LL - Z73_GetStat(STATUS): no new events\n", error));
-                    break;
-                }
-            }
+            blk->size = 0;
+
+            irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+
+            if( Z73_STATUSQ_EMPTY( llHdl ) )
+                getStatus( llHdl, 0 );
+
+            while( n < max && statusGet( llHdl, &dst[n] ) )
+                n++;
+
+            if( !n && max )
+                error = Z073_ERR_NO_STATUS;
+
+            if( Z73_STATUSQ_EMPTY( llHdl ) )
+                sigRearm( llHdl );
+            irqArm( llHdl );
+            OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+
+            blk->size = n * sizeof(Z73_EVENT);
+            qAdapt( llHdl );
+            break;
+        }
+        /*--------------------------+
+        |   trace records           |
+        +--------------------------*/
+        case Z073_BLK_TRACE:
+        {
+#ifdef Z73_TRACE
+            OSS_IRQ_STATE irqState;
+            Z73_TRC_REC *dst = (Z73_TRC_REC*)blk->data;
+            u_int32 n = 0, max = (u_int32)blk->size / sizeof(Z73_TRC_REC);
 
-            *valueP = (int32)llHdl->statusQ[llHdl->statusQOut++];
+            irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+            while( n < max && llHdl->trcOut != llHdl->trcIn )
+            {
+                dst[n++] = llHdl->trc[llHdl->trcOut];
+                llHdl->trcOut = (llHdl->trcOut + 1) % Z73_TRC_DEPTH;
+            }
+            OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
 
-            if( llHdl->statusQOut == llHdl->statusQDepth )
-                llHdl->statusQOut = 0;
+            blk->size = n * sizeof(Z73_TRC_REC);
+#else
+            error = ERR_LL_ILL_FUNC;
+#endif
+            break;
+        }
+        /*--------------------------+
+        |   register access log     |
+        +--------------------------*/
+        case Z073_BLK_MMIO:
+        {
+#ifdef Z73_MMIO_LOG
+            OSS_IRQ_STATE irqState;
+            Z73_MMIO_REC *dst = (Z73_MMIO_REC*)blk->data;
+            u_int32 n = 0, max = (u_int32)blk->size / sizeof(Z73_MMIO_REC);
 
+            irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+            while( n < max && llHdl->mmioOut != llHdl->mmioIn )
+            {
+                dst[n++] = llHdl->mmio[llHdl->mmioOut];
+                llHdl->mmioOut = (llHdl->mmioOut + 1) % Z73_MMIO_DEPTH;
+            }
+            OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
 
+            blk->size = n * sizeof(Z73_MMIO_REC);
+#else
+            error = ERR_LL_ILL_FUNC;
+#endif
             break;
         }
         /*--------------------------+
@@ -635,7 +1357,13 @@ static int32 Z73_BlockWrite(
 /****************************** Z73_Irq ************************************/
 /** Interrupt service routine
  *
- *  The interrupt is triggered when ??? occurs.
+ *  The interrupt is triggered when the push button is pressed/released or
+ *  the position changes (if the corresponding cause is enabled).
+ *
+ *  The ISR reads and acknowledges the interrupt register. The snapshot is
+ *  either processed directly (default) or, with descriptor key
+ *  Z073_DEFERRED set, stored and processed by deferProcess() outside of
+ *  the interrupt.
  *
  *  If the driver can detect the interrupt's cause it returns
  *  LL_IRQ_DEVICE or LL_IRQ_DEV_NOT, otherwise LL_IRQ_UNKNOWN.
@@ -649,45 +1377,55 @@ static int32 Z73_Irq(
    LL_HANDLE *llHdl
 )
 {
-    u_int32 irqReg = 0;
-    int32 getStatusError = ERR_SUCCESS;
+    u_int32 irqReg = 0, irqRaw, realMsec;
+    OSS_IRQ_STATE irqState;
+
+    Z73_MMIO_EV( llHdl, Z073_MMIO_IRQ, 0 );
+    irqRaw = Z73_RD( llHdl, Z073_IRQ );
+
+    irqReg = irqRaw & llHdl->irqArmed; /* only consider bits where irq enabled */
+    if( !irqReg )
+        return( LL_IRQ_DEV_NOT );
+
+    /* acknowledge, a press/release status also reports the movement */
+    if( irqReg & (Z073_IRQ_PRS | Z073_IRQ_REL) )
+        Z73_WR( llHdl, Z073_IRQ, Z073_IRQ_PRS | Z073_IRQ_REL |
+                                 Z073_IRQ_UP  | Z073_IRQ_DWN );
+    else
+        Z73_WR( llHdl, Z073_IRQ, irqReg & (Z073_IRQ_UP | Z073_IRQ_DWN) );
 
-    IDBGWRT_1((DBH, ">>> Z73_Irq\n"));
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+    Z73_TRC( llHdl, Z073_TRC_IRQ, irqRaw, llHdl->irqEn );
 
-    irqReg = MREAD_D32( llHdl->ma, Z073_IRQ );
+    if( llHdl->cap )
+        capWrite( llHdl, irqRaw );
 
-    irqReg &= llHdl->irqEn; /* only consider bits where irq enabled */
-    if( irqReg  )
+    if( llHdl->deferred )
     {
-        if( irqReg & (Z073_IRQ_PRS | Z073_IRQ_REL) )
+        /* full: process the oldest snapshot here, merging snapshots
+         * would lose the order of the events */
+        if( ((llHdl->rawQIn + 1) % Z73_RAWQ_SIZE) == llHdl->rawQOut )
         {
-            if( (getStatusError = getStatus( llHdl )) )
-            {
-                llHdl->error = getStatusError;
-                /* disable interrupts */
-                MWRITE_D32( llHdl->ma, Z073_IRQ_EN, 0x00 );
-                IDBGWRT_ERR((DBH, ">>>*** Z73_Irq: Queue Full, all interrupts disabled!!\n"));
-            }
+            u_int32 oldRaw = llHdl->rawQ[llHdl->rawQOut];
 
-            /* if requested send signal to application */
-            if( llHdl->prsRelSig ) {
-                OSS_SigSend( llHdl->osHdl, llHdl->prsRelSig );
-            }
-            MWRITE_D32( llHdl->ma, Z073_IRQ, irqReg &
-                                             (Z073_IRQ_PRS | Z073_IRQ_REL) );
-        } else
+            llHdl->rawQOut = (llHdl->rawQOut + 1) % Z73_RAWQ_SIZE;
+            Z73_TRC( llHdl, Z073_TRC_PROCESS, oldRaw, 0 );
+            irqProcess( llHdl, oldRaw );
+        }
+        llHdl->rawQ[llHdl->rawQIn] = irqRaw;
+        llHdl->rawQIn = (llHdl->rawQIn + 1) % Z73_RAWQ_SIZE;
+
+        if( !llHdl->deferArmed )
         {
-            /* if requested send signal to application */
-            if( llHdl->upDwnSig ) {
-                OSS_SigSend( llHdl->osHdl, llHdl->upDwnSig );
-            }
-            MWRITE_D32( llHdl->ma, Z073_IRQ, irqReg &
-                                             (Z073_IRQ_UP | Z073_IRQ_DWN) );
+            llHdl->deferArmed = TRUE;
+            OSS_AlarmSet( llHdl->osHdl, llHdl->deferAlarm, 1, FALSE,
+                          &realMsec );
         }
     } else
     {
-        return( LL_IRQ_DEV_NOT );
+        irqProcess( llHdl, irqRaw );
     }
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
 
     llHdl->irqCount++;
     return(LL_IRQ_DEVICE);
@@ -804,7 +1542,7 @@ static int32 Z73_Info(
         {
             u_int32 *lockModeP = va_arg(argptr, u_int32*);
 
-            *lockModeP = LL_LOCK_CALL;
+            *lockModeP = LL_LOCK_NONE;  /* driver locks internally */
             break;
         }
         /*-------------------------------+
@@ -843,8 +1581,7 @@ static int32 Cleanup(
    int32        retCode
 )
 {
-    DBGWRT_1((DBH, "Z73 Cleanup: statusQ*=0x%08x   size=%d llHdl*=0x%08p\n",
-     (u_int32 *)llHdl->statusQ, (int)llHdl->statusQSizeGot, llHdl));
+    DBGWRT_1((DBH, "Z73 Cleanup: llHdl*=0x%08p\n", llHdl));
     /*------------------------------+
     |  close handles                |
     +------------------------------*/
@@ -852,15 +1589,78 @@ static int32 Cleanup(
     if (llHdl->descHdl)
         DESC_Exit(&llHdl->descHdl);
 
+    /* release the checkpoint id, the entry is kept if a checkpoint was
+     * stored */
+    if( llHdl->ckpt )
+    {
+        llHdl->ckpt->open = FALSE;
+        if( !llHdl->ckpt->used )
+            llHdl->ckpt->id = 0;
+    }
+
+    /* remove alarms */
+    if( llHdl->deferAlarm )
+        OSS_AlarmRemove( llHdl->osHdl, &llHdl->deferAlarm );
+    if( llHdl->sigLatAlarm )
+        OSS_AlarmRemove( llHdl->osHdl, &llHdl->sigLatAlarm );
+    if( llHdl->wdogAlarm )
+        OSS_AlarmRemove( llHdl->osHdl, &llHdl->wdogAlarm );
+    if( llHdl->qGrowAlarm )
+        OSS_AlarmRemove( llHdl->osHdl, &llHdl->qGrowAlarm );
+
+    if( llHdl->gestAlarm )
+        OSS_AlarmRemove( llHdl->osHdl, &llHdl->gestAlarm );
+
+    /* remove signals */
+    if( llHdl->prsRelSig )
+        OSS_SigRemove( llHdl->osHdl, &llHdl->prsRelSig );
+    if( llHdl->upDwnSig )
+        OSS_SigRemove( llHdl->osHdl, &llHdl->upDwnSig );
+    if( llHdl->gestSig )
+        OSS_SigRemove( llHdl->osHdl, &llHdl->gestSig );
+    if( llHdl->readySig )
+        OSS_SigRemove( llHdl->osHdl, &llHdl->readySig );
+    evtSigRemove( llHdl );
+
+    /* remove semaphores */
+    if( llHdl->readySem )
+        OSS_SemRemove( llHdl->osHdl, &llHdl->readySem );
+    if( llHdl->cfgSem )
+        OSS_SemRemove( llHdl->osHdl, &llHdl->cfgSem );
+
     /* clean up debug */
     DBGEXIT((&DBH));
 
     /*------------------------------+
     |  free memory                  |
     +------------------------------*/
-    /* free status queue */
-    if( llHdl->statusQ )
-        OSS_MemFree(llHdl->osHdl, (int8*)llHdl->statusQ, llHdl->statusQSizeGot);
+    /* free status queues */
+    qFree( llHdl, &llHdl->btnQ );
+    qFree( llHdl, &llHdl->movQ );
+    if( llHdl->qSpare )
+        OSS_MemFree(llHdl->osHdl, (int8*)llHdl->qSpare, llHdl->qSpareGot);
+    if( llHdl->qOld )
+        OSS_MemFree(llHdl->osHdl, (int8*)llHdl->qOld, llHdl->qOldGot);
+
+    /* free summary ring */
+    if( llHdl->sum )
+        OSS_MemFree(llHdl->osHdl, (int8*)llHdl->sum, llHdl->sumSizeGot);
+
+    /* free capture ring */
+    if( llHdl->cap )
+        OSS_MemFree(llHdl->osHdl, (int8*)llHdl->cap, llHdl->capSizeGot);
+
+#ifdef Z73_TRACE
+    /* free trace ring */
+    if( llHdl->trc )
+        OSS_MemFree(llHdl->osHdl, (int8*)llHdl->trc, llHdl->trcSizeGot);
+#endif
+
+#ifdef Z73_MMIO_LOG
+    /* free register access log */
+    if( llHdl->mmio )
+        OSS_MemFree(llHdl->osHdl, (int8*)llHdl->mmio, llHdl->mmioSizeGot);
+#endif
 
     /* free my handle */
     OSS_MemFree(llHdl->osHdl, (int8*)llHdl, llHdl->memAlloc);
@@ -871,53 +1671,2136 @@ static int32 Cleanup(
     return(retCode);
 }
 
-static int32 getStatus( LL_HANDLE* llHdl )
+/********************************* getStatus *******************************/
+/** Read the hardware status and place it in the status queue
+ *
+ *  Used when no interrupt reported the status. Must be called with the
+ *  interrupt masked.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param noQueue    \IN  Z073_STATUS_xxx event bits not to queue
+ *
+ *  \return           \c 0 on success or Z073_ERR_STATUSQ_FULL (button
+ *                    entry dropped and counted, see putStatus())
+ */
+static int32 getStatus( LL_HANDLE* llHdl, u_int32 noQueue )
+{
+    int32 error;
+
+    error = buildStatus( llHdl, Z73_RD( llHdl, Z073_IRQ ), noQueue );
+
+    /* status reported, clear bits */
+    Z73_WR( llHdl, Z073_IRQ, Z073_IRQ_PRS | Z073_IRQ_REL |
+                             Z073_IRQ_UP  | Z073_IRQ_DWN );
+
+    return( error );
+}
+
+/******************************** buildStatus ******************************/
+/** Build status words from an interrupt register snapshot and the
+ *  position counter and place them in the status queues
+ *
+ *  Unreported movement goes to the movement queue, press/release to the
+ *  button queue. Both entries carry the current input levels.
+ *
+ *  Must be called with the interrupt masked.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param curIrqStat \IN  content of Z073_IRQ register
+ *  \param noQueue    \IN  Z073_STATUS_xxx event bits not to queue
+ *
+ *  \return           \c 0 on success or Z073_ERR_STATUSQ_FULL (button
+ *                    entry dropped and counted, see putStatus())
+ */
+static int32 buildStatus( LL_HANDLE* llHdl, u_int32 curIrqStat, u_int32 noQueue )
 {
     u_int32 retVal = 0;
+    u_int32 inputs;
+
+    readPosCnt( llHdl );
+
+    /* also get current status of inputs for debug purposes ? */
+    inputs = (curIrqStat &
+              (Z073_IRQ_STS_PRSREL|Z073_IRQ_STS_B|Z073_IRQ_STS_A)) << 24;
+
+    llHdl->moveIrq = FALSE;
+
+    /* report everything read from the counter since the last entry,
+     * it happened before the button event */
+    movePut( llHdl, inputs );
+
+    retVal |= (curIrqStat & Z073_IRQ_PRS) ? Z073_STATUS_PRS : 0;
+    retVal |= (curIrqStat & Z073_IRQ_REL) ? Z073_STATUS_REL : 0;
+
+    if( retVal && llHdl->sum )
+    {
+        Z73_SUMMARY *s = sumGet( llHdl, llHdl->posAcc );
+
+        s->presses  += (retVal & Z073_STATUS_PRS) ? 1 : 0;
+        s->releases += (retVal & Z073_STATUS_REL) ? 1 : 0;
+    }
+
+    /* place in Q */
+    retVal &= ~noQueue;
+    if( retVal )
+        return( putStatus( llHdl, &llHdl->btnQ, retVal | inputs ) );
+
+    return( ERR_SUCCESS );
+}
+
+/******************************** irqProcess *******************************/
+/** Decode an interrupt register snapshot, queue the status and notify
+ *
+ *  Called from Z73_Irq() or deferProcess() with the interrupt masked.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param irqRaw     \IN  content of Z073_IRQ register
+ */
+static void irqProcess( LL_HANDLE* llHdl, u_int32 irqRaw )
+{
+    u_int32 irqReg = irqRaw & llHdl->irqEn;
+
+    if( irqReg & (Z073_IRQ_PRS | Z073_IRQ_REL) )
+    {
+        u_int32 noQueue = 0;
+
+        if( llHdl->evtSig[0] )
+        {
+            /* event signals, if both pending the level tells the order */
+            if( (irqReg & Z073_IRQ_REL) && !(irqRaw & Z073_IRQ_STS_PRSREL) )
+                evtSigSend( llHdl, Z073_EVTSIG_REL );
+            if( irqReg & Z073_IRQ_PRS )
+                evtSigSend( llHdl, Z073_EVTSIG_PRS );
+            if( (irqReg & Z073_IRQ_REL) && (irqRaw & Z073_IRQ_STS_PRSREL) )
+                evtSigSend( llHdl, Z073_EVTSIG_REL );
+
+            if( llHdl->evtSigNoQ )
+                noQueue = Z073_STATUS_PRS | Z073_STATUS_REL;
+        }
+
+        /* full button queue: entry dropped and counted by putStatus() */
+        if( buildStatus( llHdl, irqRaw, noQueue ) )
+        {
+            IDBGWRT_ERR((DBH, ">>>*** Z73_Irq: Queue Full, entry dropped\n"));
+        }
+
+        if( llHdl->gestEn )
+            gestureInput( llHdl, irqRaw );
+
+        /* if requested send signal to application */
+        sigNotify( llHdl, Z73_SIGF_PRSREL );
+    } else if( irqReg )
+    {
+        if( llHdl->movQ.compact || llHdl->sum )
+        {   /* records are cheap (compact queue) or
+             * summarized per interval: keep the movement history */
+            readPosCnt( llHdl );
+            movePut( llHdl, (irqRaw & (Z073_IRQ_STS_PRSREL | Z073_IRQ_STS_B |
+                                       Z073_IRQ_STS_A)) << 24 );
+            llHdl->moveIrq = llHdl->posMoved;   /* not queued, queue full */
+        } else
+            llHdl->moveIrq = TRUE;
+
+        if( irqReg & Z073_IRQ_UP )
+            evtSigSend( llHdl, Z073_EVTSIG_UP );
+        if( irqReg & Z073_IRQ_DWN )
+            evtSigSend( llHdl, Z073_EVTSIG_DWN );
+
+        /* if requested send signal to application */
+        sigNotify( llHdl, Z73_SIGF_MOVE );
+    }
+
+    /* budget of unread entries used up ? */
+    if( llHdl->irqDemand )
+        irqArm( llHdl );
+}
+
+/******************************* deferProcess ******************************/
+/** Alarm routine: process the interrupt snapshots stored by Z73_Irq()
+ *
+ *  \param arg        \IN  low-level handle
+ */
+static void deferProcess( void *arg )
+{
+    LL_HANDLE *llHdl = (LL_HANDLE*)arg;
     OSS_IRQ_STATE irqState;
-    u_int32 curPosStat, curIrqStat;
-    int32 error = ERR_SUCCESS;
+    u_int32 irqRaw;
 
+    Z73_MMIO_EV( llHdl, Z073_MMIO_ALARM, Z073_MMIO_ALM_DEFER );
     irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+    llHdl->deferArmed = FALSE;
 
-    /* detect full queue and abort if necessary */
-    if( ( (llHdl->statusQIn + 1) == llHdl->statusQOut) ||
-        (((llHdl->statusQIn + 1) == llHdl->statusQDepth) &&
-         (llHdl->statusQOut == 0)) )
+    /* unmask between the snapshots to keep the irq latency short */
+    while( llHdl->rawQOut != llHdl->rawQIn )
     {
-        error = Z073_ERR_STATUSQ_FULL;
-        goto ERR_EXIT;
+        irqRaw = llHdl->rawQ[llHdl->rawQOut];
+        llHdl->rawQOut = (llHdl->rawQOut + 1) % Z73_RAWQ_SIZE;
+
+        Z73_TRC( llHdl, Z073_TRC_PROCESS, irqRaw, 0 );
+        irqProcess( llHdl, irqRaw );
+
+        OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+        irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
     }
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+}
 
-    curPosStat = MREAD_D32( llHdl->ma, Z073_POS_CNT );
-    curIrqStat = MREAD_D32( llHdl->ma, Z073_IRQ );
+/******************************** readPosCnt *******************************/
+/** Read (and thereby clear) the hardware position counter
+ *
+ *  The sign extended delta is added to the accumulated position and to the
+ *  delta pending for the next status entry. A changed position is stored
+ *  with timestamp in the position history for posExtrap() and added to
+ *  the current interval summary. Must be called with the interrupt
+ *  masked.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *
+ *  \return           raw value of Z073_POS_CNT
+ */
+static u_int32 readPosCnt( LL_HANDLE* llHdl )
+{
+    u_int32 curPosStat, ts;
+    int32 delta;
 
-    DBGWRT_1((DBH, "Z73 getStatus: curPosStat=0x%08X\n",curPosStat));
+    curPosStat = Z73_RD( llHdl, Z073_POS_CNT );
 
-    retVal |= (curIrqStat & Z073_IRQ_PRS) ? Z073_STATUS_PRS : 0;
-    retVal |= (curIrqStat & Z073_IRQ_REL) ? Z073_STATUS_REL : 0;
-    retVal |= (curPosStat & Z073_POS_CNT_STS) ? (Z073_STATUS_MOV |
-                                                (curPosStat & Z073_POS_CNT_CNT))
-                                              : 0;
+    if( curPosStat & Z073_POS_CNT_STS )
+    {
+        delta = ((int32)((curPosStat & Z073_POS_CNT_CNT) <<
+                         Z073_POS_CNT_SHIFT)) >> Z073_POS_CNT_SHIFT;
+        llHdl->posAcc     += delta;
+        llHdl->posPending += delta;
+        llHdl->posMoved    = TRUE;
+        Z73_TRC( llHdl, Z073_TRC_POSCNT, curPosStat, llHdl->posAcc );
+
+        ts = Z73_TIMESTAMP( llHdl );
+        if( llHdl->sum )
+            sumPos( llHdl, delta, ts );
+
+        llHdl->posHist[llHdl->posHistIn].tick = ts;
+        llHdl->posHist[llHdl->posHistIn].pos  = llHdl->posAcc;
+        llHdl->posHistIn = (llHdl->posHistIn + 1) % Z73_PHIST_NUM;
+        llHdl->posHistOs = OSS_TickGet( llHdl->osHdl );
+        if( llHdl->posHistCnt < Z73_PHIST_NUM )
+            llHdl->posHistCnt++;
+    }
 
-    /* also get current status of inputs for debug purposes ? */
-    retVal |= curIrqStat&(Z073_IRQ_STS_PRSREL|Z073_IRQ_STS_B|Z073_IRQ_STS_A)<<24;
+    return( curPosStat );
+}
+
+/********************************* putStatus *******************************/
+/** Place a status word in a status queue
+ *
+ *  One field will never get filled, otherwise more flags are needed to
+ *  detect a full queue. Must be called with the interrupt masked.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param q          \IN  queue
+ *  \param status     \IN  status word
+ *
+ *  \return           \c 0 on success or Z073_ERR_STATUSQ_FULL if the queue
+ *                    was full, the entry is dropped and counted in
+ *                    Z073_BTNQ_DROPPED. Never passed to the application.
+ */
+static int32 putStatus( LL_HANDLE* llHdl, Z73_QUEUE *q, u_int32 status )
+{
+    Z73_EVENT *ev;
+    u_int32 tick, realMsec;
 
-    /* place in Q, one field will never get filled, otherwise more flags are
-     * needed to detect full queue */
-    if( retVal & (Z073_STATUS_PRS | Z073_STATUS_REL | Z073_STATUS_MOV) )
-        llHdl->statusQ[llHdl->statusQIn++] = retVal;
+    /* drop and count, the device keeps running */
+    if( Z73_Q_FULL( q ) )
+    {
+        llHdl->btnDropped++;
+        Z73_TRC( llHdl, Z073_TRC_QFULL, status, 0 );
+        return( Z073_ERR_STATUSQ_FULL );
+    }
 
-    if( llHdl->statusQIn == llHdl->statusQDepth )
-        llHdl->statusQIn = 0;
+    tick = OSS_TickGet( llHdl->osHdl );
 
-    /* status reported, clear bits */
-    MWRITE_D32(llHdl->ma, Z073_IRQ, Z073_IRQ_PRS | Z073_IRQ_REL |
-                                    Z073_IRQ_UP  | Z073_IRQ_UP );
+    if( q->compact )
+    {
+        cqPut( q, status, tick, llHdl->evSeq++ );
+    } else
+    {
+        ev = &q->ent[q->in];
+        ev->status = status;
+        ev->tick   = tick;
+        ev->seq    = llHdl->evSeq++;
+
+        if( ++q->in == q->depth )
+            q->in = 0;
+    }
+
+    if( Z73_Q_FILL( q ) > q->hwm )
+        q->hwm = Z73_Q_FILL( q );
+
+    /* adaptive movement queue: grow when it comes close to the depth,
+     * also while nobody reads */
+    if( q == &llHdl->movQ && llHdl->qSpare && !llHdl->qGrowArmed &&
+        q->hwm >= (Z73_Q_DEPTH( q ) - 1) * 3 / 4 )
+    {
+        llHdl->qGrowArmed = TRUE;
+        OSS_AlarmSet( llHdl->osHdl, llHdl->qGrowAlarm, 1, FALSE, &realMsec );
+    }
+
+    Z73_TRC( llHdl, Z073_TRC_STATUS, status, Z73_Q_FILL( q ) );
+    return( ERR_SUCCESS );
+}
+
+/********************************** movePut ********************************/
+/** Place the movement not yet reported in the movement queue
+ *
+ *  If the queue is full, the movement is added to the newest entry as
+ *  long as the sum fits into the count field, otherwise it stays pending
+ *  until the application has read entries. With compact storage it
+ *  always stays pending. A full movement queue is therefore
+ *  never an error. Movement beyond the range of the count field (folded
+ *  in by the watchdog) is split into several entries. Must be called
+ *  with the interrupt masked.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param inputs     \IN  input levels (Z073_STATUS_PRESS_N/INPUT_A/B)
+ */
+static void movePut( LL_HANDLE* llHdl, u_int32 inputs )
+{
+    Z73_QUEUE *q = &llHdl->movQ;
+    Z73_EVENT *ev;
+    int32 sum, part;
+
+    while( llHdl->posMoved )
+    {
+        part = llHdl->posPending;
+        if( part > Z73_STATUS_CNT_MAX )
+            part = Z73_STATUS_CNT_MAX;
+        else if( part < Z73_STATUS_CNT_MIN )
+            part = Z73_STATUS_CNT_MIN;
+
+        if( !Z73_Q_FULL( q ) )
+        {
+            putStatus( llHdl, q, Z073_STATUS_MOV | inputs |
+                                 (part & Z073_STATUS_CNT) );
+        } else
+        {
+            if( q->compact )
+                return;
+
+            /* coalesce with newest entry, which now ends later than
+             * button entries queued since: take a new sequence number */
+            ev  = &q->ent[(q->in + q->depth - 1) % q->depth];
+            sum = Z73_STATUS_CNT_GET( ev->status ) + part;
+            if( sum < Z73_STATUS_CNT_MIN || sum > Z73_STATUS_CNT_MAX )
+                return;
+
+            ev->status = Z073_STATUS_MOV | inputs | (sum & Z073_STATUS_CNT);
+            ev->tick   = OSS_TickGet( llHdl->osHdl );
+            ev->seq    = llHdl->evSeq++;
+            Z73_TRC( llHdl, Z073_TRC_QMERGE, ev->status, Z73_Q_FILL( q ) );
+        }
+
+        llHdl->posPending -= part;
+        llHdl->posMoved    = (llHdl->posPending != 0);
+    }
+}
+
+/********************************* statusGet *******************************/
+/** Remove the next entry from the status queues
+ *
+ *  With Z073_QORDER_PRIO the button queue is read first, otherwise the
+ *  entry which occurred first. Must be called with the interrupt masked.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param ev         \OUT entry
+ *
+ *  \return           TRUE if an entry was read, FALSE if both queues empty
+ */
+static int32 statusGet( LL_HANDLE* llHdl, Z73_EVENT *ev )
+{
+    Z73_QUEUE *btnQ = &llHdl->btnQ;
+    Z73_QUEUE *movQ = &llHdl->movQ;
+    Z73_EVENT btnEv, movEv;
+    u_int32 btnLen = 0, movLen = 0;
+
+    if( !Z73_Q_EMPTY( btnQ ) )
+        btnLen = qPeek( btnQ, &btnEv );
+    if( !Z73_Q_EMPTY( movQ ) )
+        movLen = qPeek( movQ, &movEv );
+
+    if( btnLen && (!movLen || llHdl->qOrder == Z073_QORDER_PRIO ||
+                   (int32)(btnEv.seq - movEv.seq) < 0) )
+    {
+        qDrop( btnQ, &btnEv, btnLen );
+        *ev = btnEv;
+    } else if( movLen )
+    {
+        qDrop( movQ, &movEv, movLen );
+        *ev = movEv;
+    } else
+        return( FALSE );
+
+    return( TRUE );
+}
+
+/*********************************** qPeek *********************************/
+/** Get the oldest entry of a (not empty) status queue without removing it
+ *
+ *  \param q          \IN  queue
+ *  \param ev         \OUT entry
+ *
+ *  \return           number of fields used by the entry
+ */
+static u_int32 qPeek( Z73_QUEUE *q, Z73_EVENT *ev )
+{
+    u_int8 b0, b1;
+
+    if( !q->compact )
+    {
+        *ev = q->ent[q->out];
+        return( 1 );
+    }
+
+    b0 = q->cbuf[q->out];
+    if( b0 == Z73_CQ_ESC )
+    {   /* full record */
+        ev->status = cqGet32( q, 1 );
+        ev->tick   = cqGet32( q, 5 );
+        ev->seq    = cqGet32( q, 9 );
+        return( Z73_CQ_FULL );
+    }
+
+    /* short record: position delta, inputs and tick delta */
+    b1 = q->cbuf[(q->out + 1) % q->depth];
+    ev->status = Z073_STATUS_MOV |
+                 ((u_int32)(b1 >> 5) << 28) |
+                 ((u_int32)(int32)(int8)b0 & Z073_STATUS_CNT);
+    ev->tick   = q->outTick + (b1 & Z73_CQ_TMAX);
+    ev->seq    = q->outSeq + 1;
+    return( Z73_CQ_SHORT );
+}
+
+/*********************************** qDrop *********************************/
+/** Remove the oldest entry of a status queue after qPeek()
+ *
+ *  \param q          \IN  queue
+ *  \param ev         \IN  entry returned by qPeek()
+ *  \param len        \IN  length returned by qPeek()
+ */
+static void qDrop( Z73_QUEUE *q, Z73_EVENT *ev, u_int32 len )
+{
+    q->out = (q->out + len) % q->depth;
+
+    if( q->compact )
+    {
+        q->outTick = ev->tick;
+        q->outSeq  = ev->seq;
+        q->cnt--;
+    }
+}
+
+/*********************************** cqPut *********************************/
+/** Append a record to a compact status queue
+ *
+ *  A movement entry following the previous one directly (no button event
+ *  in between) is stored as short record if the count and tick deltas are
+ *  small. All others, and every Z73_CQ_KEYINT records a keyframe, are
+ *  stored as full record. The caller checks for space.
+ *
+ *  \param q          \IN  queue
+ *  \param status     \IN  status word
+ *  \param tick       \IN  time of entry
+ *  \param seq        \IN  sequence number of entry
+ */
+static void cqPut( Z73_QUEUE *q, u_int32 status, u_int32 tick, u_int32 seq )
+{
+    int32 cnt = Z73_STATUS_CNT_GET( status );
+    u_int32 dt = tick - q->inTick;
+
+    if( q->keyCnt < Z73_CQ_KEYINT && q->cnt && seq == q->inSeq + 1 &&
+        dt <= Z73_CQ_TMAX && cnt >= -127 && cnt <= 127 &&
+        (status & ~(Z073_STATUS_CNT | Z73_CQ_INPUTS)) == Z073_STATUS_MOV )
+    {
+        cqPutByte( q, (u_int8)cnt );
+        cqPutByte( q, (u_int8)(((status & Z73_CQ_INPUTS) >> 23) | dt) );
+        q->keyCnt++;
+    } else
+    {
+        cqPutByte( q, Z73_CQ_ESC );
+        cqPut32( q, status );
+        cqPut32( q, tick );
+        cqPut32( q, seq );
+        q->keyCnt = 0;
+    }
+
+    q->inTick = tick;
+    q->inSeq  = seq;
+    q->cnt++;
+}
+
+/********************************* cqPutByte *******************************/
+/** Append a byte to a compact status queue
+ *
+ *  \param q          \IN  queue
+ *  \param val        \IN  value
+ */
+static void cqPutByte( Z73_QUEUE *q, u_int8 val )
+{
+    q->cbuf[q->in] = val;
+    if( ++q->in == q->depth )
+        q->in = 0;
+}
+
+/********************************** cqPut32 ********************************/
+/** Append a 32 bit value to a compact status queue (little endian)
+ *
+ *  \param q          \IN  queue
+ *  \param val        \IN  value
+ */
+static void cqPut32( Z73_QUEUE *q, u_int32 val )
+{
+    int32 i;
+
+    for( i=0; i<4; i++ )
+        cqPutByte( q, (u_int8)(val >> (i * 8)) );
+}
+
+/********************************** cqGet32 ********************************/
+/** Read a 32 bit value from a compact status queue (little endian)
+ *
+ *  \param q          \IN  queue
+ *  \param off        \IN  offset from oldest byte
+ *
+ *  \return           value
+ */
+static u_int32 cqGet32( Z73_QUEUE *q, u_int32 off )
+{
+    u_int32 val = 0;
+    int32 i;
+
+    for( i=3; i>=0; i-- )
+        val = (val << 8) | q->cbuf[(q->out + off + i) % q->depth];
+
+    return( val );
+}
+
+/********************************** qAlloc *********************************/
+/** Allocate a status queue
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param q          \IN  queue, compact flag set
+ *  \param depth      \IN  number of entries
+ *
+ *  \return           \c 0 on success or error code
+ */
+static int32 qAlloc( LL_HANDLE* llHdl, Z73_QUEUE *q, u_int32 depth )
+{
+    u_int32 gotsize, size;
+    void *buf;
+
+    /* Z73_Q_SIZE() and the byte size can't overflow */
+    if( depth < 2 || depth > Z73_Q_MAX )
+        return( ERR_LL_ILL_PARAM );
+
+    size = Z73_Q_SIZE( q, depth );
+    if ((buf = OSS_MemGet( llHdl->osHdl,
+                           size * (q->compact ? 1 : sizeof(Z73_EVENT)),
+                           &gotsize )) == NULL)
+        return( ERR_OSS_MEM_ALLOC );
+
+    OSS_MemFill( llHdl->osHdl, gotsize, (char*)buf, 0x00 );
+    if( q->compact )
+        q->cbuf = (u_int8*)buf;
+    else
+        q->ent  = (Z73_EVENT*)buf;
+    q->sizeGot = gotsize;
+    q->depth   = size;
+    q->in      = 0;
+    q->out     = 0;
+    q->hwm     = 0;
+    q->cnt     = 0;
+
+    return( ERR_SUCCESS );
+}
+
+/********************************** qFree **********************************/
+/** Free a status queue
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param q          \IN  queue
+ */
+static void qFree( LL_HANDLE* llHdl, Z73_QUEUE *q )
+{
+    if( q->ent )
+        OSS_MemFree( llHdl->osHdl, (int8*)q->ent, q->sizeGot );
+    if( q->cbuf )
+        OSS_MemFree( llHdl->osHdl, (int8*)q->cbuf, q->sizeGot );
+    q->ent  = NULL;
+    q->cbuf = NULL;
+}
+
+/********************************* qResize *********************************/
+/** Change the depth of a status queue, keeping the queued entries
+ *
+ *  The new buffer is allocated before and the old one freed after the
+ *  entries are moved with the interrupt masked, so no event is lost.
+ *  Compact records are moved unchanged. Must not be called from interrupt
+ *  or alarm context.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param q          \IN  queue
+ *  \param depth      \IN  new number of entries
+ *
+ *  \return           \c 0 on success or error code,
+ *                    ERR_LL_ILL_PARAM if the entries don't fit
+ */
+static int32 qResize( LL_HANDLE* llHdl, Z73_QUEUE *q, u_int32 depth )
+{
+    OSS_IRQ_STATE irqState;
+    u_int8 *buf, *oldBuf;
+    u_int32 gotsize, oldSize, size, elSize;
+    int32 error = ERR_SUCCESS;
+
+    /* Z73_Q_SIZE() and the byte size can't overflow */
+    if( depth < 2 || depth > Z73_Q_MAX )
+        return( ERR_LL_ILL_PARAM );
+
+    size   = Z73_Q_SIZE( q, depth );
+    elSize = q->compact ? 1 : sizeof(Z73_EVENT);
+
+    if ((buf = (u_int8*)OSS_MemGet(
+                    llHdl->osHdl, size * elSize, &gotsize)) == NULL)
+        return( ERR_OSS_MEM_ALLOC );
 
-ERR_EXIT:
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+    if( Z73_Q_USED( q ) >= size )
+    {
+        error = ERR_LL_ILL_PARAM;
+        oldBuf  = buf;      /* free new buffer */
+        oldSize = gotsize;
+    } else
+    {
+        oldBuf  = q->compact ? q->cbuf : (u_int8*)q->ent;
+        oldSize = q->sizeGot;
+        qMove( llHdl, q, buf, gotsize, size );
+    }
     OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+
+    OSS_MemFree( llHdl->osHdl, (int8*)oldBuf, oldSize );
+
+    DBGWRT_2((DBH, "LL - Z73 qResize: depth=%d entries=%d error=0x%x\n",
+              (int)depth, (int)Z73_Q_FILL( q ), error));
     return( error );
 }
 
+/********************************** qAdapt *********************************/
+/** Adapt the depth of the movement queue to the load
+ *
+ *  Called after the application has read entries. The queue is doubled
+ *  (up to Z073_STATUSQ_MAX) when the fill level since the last call came
+ *  close to the depth. It shrinks back to Z073_STATUSQ_SIZE when it was
+ *  not more than half full for Z073_STATUSQ_QUIET ms. Resizing is skipped
+ *  while a SetStat is running. Afterwards the buffer for the next grow
+ *  step of the producer side (qGrowAlarm()) is prepared.
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void qAdapt( LL_HANDLE* llHdl )
+{
+    Z73_QUEUE *q = &llHdl->movQ;
+    OSS_IRQ_STATE irqState;
+    u_int32 hwm, depth, now, newDepth = 0;
+
+    if( !llHdl->qAdaptMax )
+        return;
+
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+    hwm    = q->hwm;
+    depth  = Z73_Q_DEPTH( q );
+    q->hwm = Z73_Q_FILL( q );
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+
+    now = OSS_TickGet( llHdl->osHdl );
+    if( hwm > (llHdl->movQBase - 1) / 2 )
+        llHdl->qBusyTick = now;
+
+    if( hwm >= (depth - 1) * 3 / 4 && depth < llHdl->qAdaptMax )
+    {
+        newDepth = (depth * 2 < llHdl->qAdaptMax) ? depth * 2 :
+                                                    llHdl->qAdaptMax;
+    } else if( depth > llHdl->movQBase &&
+               (now - llHdl->qBusyTick) >= llHdl->qAdaptQuiet *
+                                     OSS_TickRateGet( llHdl->osHdl ) / 1000 )
+    {
+        newDepth = llHdl->movQBase;
+    }
+
+    if( OSS_SemWait( llHdl->osHdl, llHdl->cfgSem, OSS_SEM_NOWAIT ) )
+        return;
+
+    /* fails if the entries don't fit yet, try again next time */
+    if( newDepth )
+        qResize( llHdl, q, newDepth );
+    qSpareGet( llHdl );
+    OSS_SemSignal( llHdl->osHdl, llHdl->cfgSem );
+}
+
+/*********************************** qMove *********************************/
+/** Move the queued entries to a new buffer, oldest first
+ *
+ *  Must be called with the interrupt masked. Compact records are moved
+ *  unchanged. The caller frees the old buffer.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param q          \IN  queue
+ *  \param buf        \IN  new buffer, must hold the entries
+ *  \param gotsize    \IN  size of buf allocated
+ *  \param size       \IN  entries/bytes of buf (Z73_Q_SIZE)
+ */
+static void qMove( LL_HANDLE* llHdl, Z73_QUEUE *q, u_int8 *buf,
+                   u_int32 gotsize, u_int32 size )
+{
+    u_int8 *oldBuf = q->compact ? q->cbuf : (u_int8*)q->ent;
+    u_int32 elSize = q->compact ? 1 : sizeof(Z73_EVENT);
+    u_int32 n = 0;
+
+    while( q->out != q->in )
+    {
+        OSS_MemCopy( llHdl->osHdl, elSize,
+                     (char*)&oldBuf[q->out * elSize],
+                     (char*)&buf[n++ * elSize] );
+        if( ++q->out == q->depth )
+            q->out = 0;
+    }
+
+    if( q->compact )
+        q->cbuf = buf;
+    else
+        q->ent  = (Z73_EVENT*)buf;
+    q->sizeGot = gotsize;
+    q->depth   = size;
+    q->in      = n;
+    q->out     = 0;
+    q->hwm     = Z73_Q_FILL( q );
+}
+
+/********************************* qSpareGet *******************************/
+/** Prepare the buffer for the next grow step of the movement queue
+ *
+ *  Memory can't be allocated in interrupt or alarm context, so the buffer
+ *  of the doubled depth (up to Z073_STATUSQ_MAX) is allocated ahead and
+ *  taken by qGrowAlarm(). Also frees the buffer replaced by the alarm.
+ *  Called with cfgSem held (SetStat, qAdapt) or from Z73_Init().
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void qSpareGet( LL_HANDLE* llHdl )
+{
+    Z73_QUEUE *q = &llHdl->movQ;
+    OSS_IRQ_STATE irqState;
+    u_int8 *spare, *old;
+    u_int32 spareGot, oldGot, depth, want = 0, gotsize;
+
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+    depth = Z73_Q_DEPTH( q );
+    if( llHdl->qAdaptMax && depth < llHdl->qAdaptMax )
+        want = Z73_Q_SIZE( q, depth * 2 < llHdl->qAdaptMax ?
+                              depth * 2 : llHdl->qAdaptMax );
+
+    /* take buffers no longer needed */
+    old      = llHdl->qOld;
+    oldGot   = llHdl->qOldGot;
+    llHdl->qOld = NULL;
+    spare    = NULL;
+    spareGot = 0;
+    if( llHdl->qSpare && llHdl->qSpareDepth != want )
+    {
+        spare    = llHdl->qSpare;
+        spareGot = llHdl->qSpareGot;
+        llHdl->qSpare = NULL;
+    }
+    if( llHdl->qSpare )
+        want = 0;   /* still matches */
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+
+    if( old )
+        OSS_MemFree( llHdl->osHdl, (int8*)old, oldGot );
+    if( spare )
+        OSS_MemFree( llHdl->osHdl, (int8*)spare, spareGot );
+
+    if( !want ||
+        (spare = (u_int8*)OSS_MemGet( llHdl->osHdl,
+                         want * (q->compact ? 1 : sizeof(Z73_EVENT)),
+                         &gotsize )) == NULL )
+        return;     /* no memory: the queue coalesces as without spare */
+
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+    llHdl->qSpare      = spare;
+    llHdl->qSpareGot   = gotsize;
+    llHdl->qSpareDepth = want;
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+}
+
+/******************************** qGrowAlarm *******************************/
+/** Alarm routine: grow the movement queue with the prepared buffer
+ *
+ *  Armed by putStatus() when the fill level comes close to the depth, so
+ *  the queue also grows while the application does not read. The next
+ *  step is prepared when the application enters the driver again.
+ *
+ *  \param arg        \IN  low-level handle
+ */
+static void qGrowAlarm( void *arg )
+{
+    LL_HANDLE *llHdl = (LL_HANDLE*)arg;
+    Z73_QUEUE *q = &llHdl->movQ;
+    OSS_IRQ_STATE irqState;
+
+    Z73_MMIO_EV( llHdl, Z073_MMIO_ALARM, Z073_MMIO_ALM_QGROW );
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+    llHdl->qGrowArmed = FALSE;
+
+    if( llHdl->qSpare && !llHdl->qOld && llHdl->qSpareDepth > q->depth )
+    {
+        llHdl->qOld    = q->compact ? q->cbuf : (u_int8*)q->ent;
+        llHdl->qOldGot = q->sizeGot;
+        qMove( llHdl, q, llHdl->qSpare, llHdl->qSpareGot,
+               llHdl->qSpareDepth );
+        llHdl->qSpare = NULL;
+        Z73_TRC( llHdl, Z073_TRC_QGROW, Z73_Q_DEPTH( q ), Z73_Q_FILL( q ) );
+    }
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+}
+
+/******************************** gestureArm *******************************/
+/** (Re)start the gesture alarm
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param msec       \IN  alarm time [ms], 0 only stops the alarm
+ *  \param cyclic     \IN  cyclic alarm
+ */
+static void gestureArm( LL_HANDLE* llHdl, u_int32 msec, u_int32 cyclic )
+{
+    u_int32 realMsec;
+
+    OSS_AlarmClear( llHdl->osHdl, llHdl->gestAlarm );
+    if( msec )
+        OSS_AlarmSet( llHdl->osHdl, llHdl->gestAlarm, msec, cyclic, &realMsec );
+}
+
+/******************************** gestureEmit ******************************/
+/** Queue a gesture event and notify the application
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param code       \IN  \ref gesture_codes "gesture code"
+ */
+static void gestureEmit( LL_HANDLE* llHdl, u_int32 code )
+{
+    int32 error;
+
+    Z73_TRC( llHdl, Z073_TRC_GESTURE, code, llHdl->gestState );
+
+    if( llHdl->evtSig[0] )
+    {
+        evtSigSend( llHdl, Z073_EVTSIG_GEST + code - 1 );
+        if( llHdl->evtSigNoQ )
+            return;
+    }
+
+    if( (error = putStatus( llHdl, &llHdl->btnQ, Z073_STATUS_GEST | code )) )
+    {
+        IDBGWRT_ERR((DBH, ">>>*** Z73 gesture: Queue Full, event dropped\n"));
+    }
+
+    sigNotify( llHdl, Z73_SIGF_GEST );
+}
+
+/******************************** gesturePress *****************************/
+/** Gesture state machine: push button pressed
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void gesturePress( LL_HANDLE* llHdl )
+{
+    switch( llHdl->gestState )
+    {
+        case Z73_GEST_IDLE:
+            llHdl->gestState = Z73_GEST_PRESSED;
+            gestureArm( llHdl, llHdl->gestLongMs, FALSE );
+            break;
+        case Z73_GEST_WAIT_DBL:
+            llHdl->gestState = Z73_GEST_PRESSED2;
+            gestureArm( llHdl, llHdl->gestLongMs, FALSE );
+            break;
+        default:    /* already pressed, release missed */
+            break;
+    }
+}
+
+/******************************* gestureRelease ****************************/
+/** Gesture state machine: push button released
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void gestureRelease( LL_HANDLE* llHdl )
+{
+    switch( llHdl->gestState )
+    {
+        case Z73_GEST_PRESSED:
+            if( llHdl->gestDblMs )
+            {   /* wait for a second click */
+                llHdl->gestState = Z73_GEST_WAIT_DBL;
+                gestureArm( llHdl, llHdl->gestDblMs, FALSE );
+            } else
+            {
+                gestureArm( llHdl, 0, FALSE );
+                llHdl->gestState = Z73_GEST_IDLE;
+                gestureEmit( llHdl, Z073_GEST_CLICK );
+            }
+            break;
+        case Z73_GEST_PRESSED2:
+            gestureArm( llHdl, 0, FALSE );
+            llHdl->gestState = Z73_GEST_IDLE;
+            gestureEmit( llHdl, Z073_GEST_DBLCLICK );
+            break;
+        case Z73_GEST_LONG:
+            gestureArm( llHdl, 0, FALSE );
+            llHdl->gestState = Z73_GEST_IDLE;
+            gestureEmit( llHdl, Z073_GEST_LONG_END );
+            break;
+        default:    /* not pressed, press missed */
+            break;
+    }
+}
+
+/******************************** gestureInput *****************************/
+/** Feed press/release interrupts into the gesture state machine
+ *
+ *  If press and release are both pending, the current PRESS_N level
+ *  decides which one came first. Called from Z73_Irq().
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param irqReg     \IN  content of Z073_IRQ register
+ */
+static void gestureInput( LL_HANDLE* llHdl, u_int32 irqReg )
+{
+    if( (irqReg & (Z073_IRQ_PRS | Z073_IRQ_REL)) ==
+        (Z073_IRQ_PRS | Z073_IRQ_REL) )
+    {
+        if( irqReg & Z073_IRQ_STS_PRSREL )
+        {   /* button is up now: pressed and released again */
+            gesturePress( llHdl );
+            gestureRelease( llHdl );
+        } else
+        {
+            gestureRelease( llHdl );
+            gesturePress( llHdl );
+        }
+    } else if( irqReg & Z073_IRQ_PRS )
+    {
+        gesturePress( llHdl );
+    } else if( irqReg & Z073_IRQ_REL )
+    {
+        gestureRelease( llHdl );
+    }
+}
+
+/******************************** gestureAlarm *****************************/
+/** Alarm routine of the gesture state machine
+ *
+ *  \param arg        \IN  low-level handle
+ */
+static void gestureAlarm( void *arg )
+{
+    LL_HANDLE *llHdl = (LL_HANDLE*)arg;
+    OSS_IRQ_STATE irqState;
+
+    Z73_MMIO_EV( llHdl, Z073_MMIO_ALARM, Z073_MMIO_ALM_GESTURE );
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+
+    switch( llHdl->gestState )
+    {
+        case Z73_GEST_PRESSED2: /* first click of a double click completed */
+            gestureEmit( llHdl, Z073_GEST_CLICK );
+            /* fall through */
+        case Z73_GEST_PRESSED:
+            llHdl->gestState = Z73_GEST_LONG;
+            gestureEmit( llHdl, Z073_GEST_LONG_START );
+            if( llHdl->gestRepMs )
+                gestureArm( llHdl, llHdl->gestRepMs, TRUE );
+            break;
+        case Z73_GEST_LONG:
+            gestureEmit( llHdl, Z073_GEST_REPEAT );
+            break;
+        case Z73_GEST_WAIT_DBL:
+            llHdl->gestState = Z73_GEST_IDLE;
+            gestureEmit( llHdl, Z073_GEST_CLICK );
+            break;
+        default:
+            break;
+    }
+
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+}
+
+/********************************* sigNotify *******************************/
+/** Notify the application about new events according to signal mode
+ *
+ *  Must be called with the interrupt masked.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param flags      \IN  signals to send (Z73_SIGF_xxx)
+ */
+static void sigNotify( LL_HANDLE* llHdl, u_int32 flags )
+{
+    u_int32 realMsec;
+
+    /* readiness: wake waiters, ready signal is always edge triggered */
+    OSS_SemSignal( llHdl->osHdl, llHdl->readySem );
+    if( llHdl->readySig && !(llHdl->sigSent & Z73_SIGF_READY) )
+    {
+        OSS_SigSend( llHdl->osHdl, llHdl->readySig );
+        llHdl->sigSent |= Z73_SIGF_READY;
+    }
+
+    /* only installed signals */
+    if( !llHdl->prsRelSig )
+        flags &= ~Z73_SIGF_PRSREL;
+    if( !llHdl->upDwnSig )
+        flags &= ~Z73_SIGF_MOVE;
+    if( !llHdl->gestSig )
+        flags &= ~Z73_SIGF_GEST;
+
+    /* already notified, consumer has not read the queue yet */
+    if( llHdl->sigMode != Z073_SIGMODE_EVERY )
+        flags &= ~llHdl->sigSent;
+
+    llHdl->sigPend |= flags;
+    if( !llHdl->sigPend )
+        return;
+
+    /* a movement not queued yet is reported by the next read as well */
+    if( llHdl->sigMode != Z073_SIGMODE_WATERMARK ||
+        Z73_STATUSQ_FILL( llHdl ) + (llHdl->moveIrq ? 1 : 0) >=
+        llHdl->sigWatermark )
+    {
+        sigSendPending( llHdl );
+    } else if( llHdl->sigMaxLat && !llHdl->sigLatArmed )
+    {   /* bound the latency of the first held back event */
+        llHdl->sigLatArmed = TRUE;
+        OSS_AlarmSet( llHdl->osHdl, llHdl->sigLatAlarm, llHdl->sigMaxLat,
+                      FALSE, &realMsec );
+    }
+}
+
+/******************************* sigSendPending ****************************/
+/** Send all signals held back
+ *
+ *  Must be called with the interrupt masked.
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void sigSendPending( LL_HANDLE* llHdl )
+{
+    if( llHdl->sigLatArmed )
+    {
+        OSS_AlarmClear( llHdl->osHdl, llHdl->sigLatAlarm );
+        llHdl->sigLatArmed = FALSE;
+    }
+
+    Z73_TRC( llHdl, Z073_TRC_SIGNAL, llHdl->sigPend, 0 );
+
+    if( (llHdl->sigPend & Z73_SIGF_PRSREL) && llHdl->prsRelSig )
+        OSS_SigSend( llHdl->osHdl, llHdl->prsRelSig );
+    if( (llHdl->sigPend & Z73_SIGF_MOVE) && llHdl->upDwnSig )
+        OSS_SigSend( llHdl->osHdl, llHdl->upDwnSig );
+    if( (llHdl->sigPend & Z73_SIGF_GEST) && llHdl->gestSig )
+        OSS_SigSend( llHdl->osHdl, llHdl->gestSig );
+
+    llHdl->sigSent |= llHdl->sigPend;
+    llHdl->sigPend  = 0;
+}
+
+/********************************* sigRearm ********************************/
+/** Consumer has read the queue, allow new signals
+ *
+ *  Must be called with the interrupt masked.
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void sigRearm( LL_HANDLE* llHdl )
+{
+    llHdl->sigSent = 0;
+
+    /* movement arrived while the consumer was reading, don't lose it */
+    if( llHdl->moveIrq )
+        sigNotify( llHdl, llHdl->sigMode == Z073_SIGMODE_EVERY ?
+                          0 : Z73_SIGF_MOVE );
+}
+
+/******************************** sigLatAlarm ******************************/
+/** Alarm routine: max. latency of held back signals expired
+ *
+ *  \param arg        \IN  low-level handle
+ */
+static void sigLatAlarm( void *arg )
+{
+    LL_HANDLE *llHdl = (LL_HANDLE*)arg;
+    OSS_IRQ_STATE irqState;
+
+    Z73_MMIO_EV( llHdl, Z073_MMIO_ALARM, Z073_MMIO_ALM_SIGLAT );
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+    llHdl->sigLatArmed = FALSE;
+    sigSendPending( llHdl );
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+}
+
+/********************************* waitReady *******************************/
+/** Block until the device is ready (Z073_WAIT, Z073_BLK_WAIT)
+ *
+ *  The timeout belongs to the call, so callers with different timeouts
+ *  don't disturb each other.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param tout       \IN  timeout [ms], -1=forever, 0=don't block
+ *  \param fillP      \OUT number of queued entries
+ *
+ *  \return           \c 0 if ready or error code (ERR_OSS_TIMEOUT)
+ */
+static int32 waitReady( LL_HANDLE* llHdl, int32 tout, u_int32 *fillP )
+{
+    OSS_IRQ_STATE irqState;
+    u_int32 ready;
+    int32 error;
+
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+    llHdl->waitCnt++;
+    irqArm( llHdl );    /* events seen while disarmed fire now */
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+
+    for(;;)
+    {
+        irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+        ready  = Z73_READY( llHdl );
+        *fillP = Z73_STATUSQ_FILL( llHdl );
+        if( ready && --llHdl->waitCnt )
+            OSS_SemSignal( llHdl->osHdl, llHdl->readySem ); /* wake next */
+        if( ready )
+            irqArm( llHdl );
+        OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+
+        if( ready )
+            return( 0 );
+
+        if( (error = OSS_SemWait( llHdl->osHdl, llHdl->readySem, tout )) )
+        {
+            irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+            llHdl->waitCnt--;
+            irqArm( llHdl );
+            OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+            return( error );
+        }
+    }
+}
+
+/********************************** wdogSet ********************************/
+/** Start or stop the wrap protection watchdog
+ *
+ *  The watchdog starts with the min. period, wdogAlarm() adapts it to
+ *  the speed.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param maxMs      \IN  max. period [ms], 0=off
+ */
+static void wdogSet( LL_HANDLE* llHdl, u_int32 maxMs )
+{
+    OSS_IRQ_STATE irqState;
+    u_int32 realMsec;
+
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+    OSS_AlarmClear( llHdl->osHdl, llHdl->wdogAlarm );
+
+    llHdl->wdogMax = maxMs;
+    llHdl->wdogMs  = llHdl->wdogMin < maxMs ? llHdl->wdogMin : maxMs;
+    llHdl->wdogPos = llHdl->posAcc;
+
+    if( maxMs )
+        OSS_AlarmSet( llHdl->osHdl, llHdl->wdogAlarm, llHdl->wdogMs, FALSE,
+                      &realMsec );
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+}
+
+/********************************* wdogAlarm *******************************/
+/** Alarm routine of the wrap protection watchdog
+ *
+ *  Reads the position counter before it can wrap. The counts only go to
+ *  the accumulated position and the pending delta, like M_read() of
+ *  Z073_CH_POS they are reported with the next status entry. The next
+ *  period is halved while the position moved by more than Z73_WDOG_SAFE
+ *  counts since the last run (by any counter read) and doubled while it
+ *  moved by less than half of that, within the min./max. period.
+ *
+ *  \param arg        \IN  low-level handle
+ */
+static void wdogAlarm( void *arg )
+{
+    LL_HANDLE *llHdl = (LL_HANDLE*)arg;
+    OSS_IRQ_STATE irqState;
+    u_int32 dist, minMs, realMsec;
+    int32 moved;
+
+    Z73_MMIO_EV( llHdl, Z073_MMIO_ALARM, Z073_MMIO_ALM_WDOG );
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+
+    /* stopped meanwhile */
+    if( !llHdl->wdogMax )
+    {
+        OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+        return;
+    }
+
+    readPosCnt( llHdl );
+    moved = llHdl->posAcc - llHdl->wdogPos;
+    dist  = (u_int32)(moved < 0 ? -moved : moved);
+    llHdl->wdogPos = llHdl->posAcc;
+
+    if( dist > Z73_WDOG_SAFE )
+        llHdl->wdogMs /= dist / Z73_WDOG_SAFE + 1;
+    else if( dist < Z73_WDOG_SAFE / 2 )
+        llHdl->wdogMs = llHdl->wdogMs > llHdl->wdogMax / 2 ?
+                        llHdl->wdogMax : llHdl->wdogMs * 2;
+
+    minMs = llHdl->wdogMin < llHdl->wdogMax ? llHdl->wdogMin : llHdl->wdogMax;
+    if( llHdl->wdogMs < minMs )
+        llHdl->wdogMs = minMs;
+
+    OSS_AlarmSet( llHdl->osHdl, llHdl->wdogAlarm, llHdl->wdogMs, FALSE,
+                  &realMsec );
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+}
+
+/******************************** evtSigSend *******************************/
+/** Send the event signal of an event
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param evt        \IN  \ref event_signals "event signal offset"
+ */
+static void evtSigSend( LL_HANDLE* llHdl, u_int32 evt )
+{
+    if( evt < Z073_EVTSIG_NUM && llHdl->evtSig[evt] )
+        OSS_SigSend( llHdl->osHdl, llHdl->evtSig[evt] );
+}
+
+/******************************* evtSigRemove ******************************/
+/** Remove all event signals
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void evtSigRemove( LL_HANDLE* llHdl )
+{
+    int32 i;
+
+    for( i=0; i<Z073_EVTSIG_NUM; i++ )
+    {
+        if( llHdl->evtSig[i] )
+            OSS_SigRemove( llHdl->osHdl, &llHdl->evtSig[i] );
+    }
+}
+
+/****************************** irqCauseEnable *****************************/
+/** Enable/disable a single interrupt cause
+ *
+ *  The interrupt is only enabled in hardware when interrupts are already
+ *  enabled (M_MK_IRQ_ENABLE).
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param enBit      \IN  Z073_IRQ_EN_xxx bit
+ *  \param irqBit     \IN  corresponding Z073_IRQ_xxx bit
+ *  \param value      \IN  0=disable, else enable
+ */
+static void irqCauseEnable(
+    LL_HANDLE *llHdl,
+    u_int32 enBit,
+    u_int32 irqBit,
+    int32 value )
+{
+    OSS_IRQ_STATE irqState;
+
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+    if( value && !(llHdl->irqEn & enBit) )
+    {  /* enable interrupt */
+        llHdl->irqEn |= enBit;
+        if( llHdl->irqOn ) /* only enable irqs if already enabled */
+            Z73_WR( llHdl, Z073_IRQ, irqBit );
+    } else if( !value )  /* disable interrupt */
+    {
+        llHdl->irqEn &= ~enBit;
+    }
+    irqArm( llHdl );
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+}
+
+/********************************** irqArm *********************************/
+/** Enable the interrupt causes in hardware which are needed now
+ *
+ *  Normally these are the configured causes while interrupts are enabled.
+ *  With Z073_IRQ_DEMAND they are only enabled while somebody waits, a
+ *  signal is installed or the ISR does timing work (gestures, capture,
+ *  summaries). Otherwise button events are taken until the number of
+ *  unread entries reaches the budget, movement only if the ISR queues it
+ *  (compact queue). Events of disabled causes stay pending in
+ *  Z073_IRQ: they are read by getStatus() or fire as soon as the cause is
+ *  enabled again. Must be called with the interrupt masked whenever one
+ *  of the conditions may have changed.
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void irqArm( LL_HANDLE* llHdl )
+{
+    u_int32 en = llHdl->irqOn ? llHdl->irqEn : 0;
+
+    if( en && llHdl->irqDemand && !Z73_IRQ_NEEDED( llHdl ) )
+    {
+        if( Z73_STATUSQ_FILL( llHdl ) >= llHdl->irqDemand )
+            en = 0;
+        else if( !llHdl->movQ.compact )
+            en &= ~(Z073_IRQ_EN_UP | Z073_IRQ_EN_DWN);
+    }
+
+    if( en != llHdl->irqArmed )
+    {
+        Z73_WR( llHdl, Z073_IRQ_EN, en );
+        llHdl->irqArmed = en;
+        Z73_TRC( llHdl, Z073_TRC_IRQARM, en, Z73_STATUSQ_FILL( llHdl ) );
+    }
+}
+
+/********************************* capWrite ********************************/
+/** Write a capture record, the oldest record is overwritten when the
+ *  ring is full
+ *
+ *  Reads the position counter, the counts are still reported by the
+ *  status queue. Called from Z73_Irq() with the interrupt masked.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param irqRaw     \IN  content of Z073_IRQ register
+ */
+static void capWrite( LL_HANDLE* llHdl, u_int32 irqRaw )
+{
+    Z73_CAP_REC *rec = &llHdl->cap[llHdl->capIn];
+    int32 posPending = llHdl->posPending;
+
+    rec->ts    = Z73_TIMESTAMP( llHdl );
+    readPosCnt( llHdl );
+    rec->irq   = irqRaw;
+    rec->delta = llHdl->posPending - posPending;
+    rec->seq   = llHdl->capSeq++;
+
+    llHdl->capIn = (llHdl->capIn + 1) % llHdl->capDepth;
+    if( llHdl->capIn == llHdl->capOut )
+        llHdl->capOut = (llHdl->capOut + 1) % llHdl->capDepth;
+}
+
+/******************************** capEnable ********************************/
+/** Start, restart or stop raw edge capture
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param depth      \IN  number of records (2..Z73_CAP_MAX), 0 stops the
+ *                         capture
+ *
+ *  \return           \c 0 on success or error code
+ */
+static int32 capEnable( LL_HANDLE* llHdl, u_int32 depth )
+{
+    OSS_IRQ_STATE irqState;
+    Z73_CAP_REC *cap = NULL, *oldCap;
+    u_int32 gotsize = 0, oldSize;
+
+    /* the byte size can't overflow */
+    if( depth == 1 || depth > Z73_CAP_MAX )
+        return( ERR_LL_ILL_PARAM );
+
+    if( depth &&
+        (cap = (Z73_CAP_REC*)OSS_MemGet( llHdl->osHdl,
+                              depth * sizeof(Z73_CAP_REC), &gotsize )) == NULL )
+        return( ERR_OSS_MEM_ALLOC );
+
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+    oldCap  = llHdl->cap;
+    oldSize = llHdl->capSizeGot;
+    llHdl->cap        = cap;
+    llHdl->capSizeGot = gotsize;
+    llHdl->capDepth   = depth;
+    llHdl->capIn      = 0;
+    llHdl->capOut     = 0;
+    llHdl->capSeq     = 0;
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+
+    if( oldCap )
+        OSS_MemFree( llHdl->osHdl, (int8*)oldCap, oldSize );
+
+    return( ERR_SUCCESS );
+}
+
+#ifdef Z73_TS_CYCLES
+/******************************* tsCalibrate *******************************/
+/** Measure the rate of the cycle counter timestamp
+ *
+ *  Counts the timestamps over at least Z73_TS_CAL_MS of system ticks,
+ *  starting at a tick edge. Busy waits, so only called from Z73_Init().
+ *  Gives up when the system tick doesn't advance.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *
+ *  \return           timestamps per second, 0=unknown
+ */
+static u_int32 tsCalibrate( LL_HANDLE* llHdl )
+{
+    u_int32 rate, ticks, tick0, tick, ts0, ts;
+
+    rate  = OSS_TickRateGet( llHdl->osHdl );
+    ticks = (rate * Z73_TS_CAL_MS + 999) / 1000;
+    if( !ticks )
+        ticks = 1;
+
+    /* wait for a tick edge */
+    ts0   = Z73_TIMESTAMP( llHdl );
+    tick0 = OSS_TickGet( llHdl->osHdl );
+    while( (tick = OSS_TickGet( llHdl->osHdl )) == tick0 )
+        if( Z73_TIMESTAMP( llHdl ) - ts0 > 0x7fffffff )
+            return( 0 );
+
+    ts0 = Z73_TIMESTAMP( llHdl );
+    do {
+        ts = Z73_TIMESTAMP( llHdl ) - ts0;
+        if( ts > 0x7fffffff )
+            return( 0 );
+    } while( OSS_TickGet( llHdl->osHdl ) - tick < ticks );
+
+    return( ts / ticks * rate + ts % ticks * rate / ticks );
+}
+#endif
+
+/******************************** sumEnable ********************************/
+/** Start, restart or stop the interval summaries
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param intv       \IN  interval [ms], 0 stops the summaries
+ *
+ *  \return           \c 0 on success or error code
+ */
+static int32 sumEnable( LL_HANDLE* llHdl, u_int32 intv )
+{
+    OSS_IRQ_STATE irqState;
+    Z73_SUMMARY *sum = NULL, *oldSum;
+    u_int32 gotsize = 0, oldSize, ticks = 0, rate;
+
+    if( intv )
+    {
+        if( (sum = (Z73_SUMMARY*)OSS_MemGet( llHdl->osHdl,
+                    llHdl->sumDepth * sizeof(Z73_SUMMARY), &gotsize )) == NULL )
+            return( ERR_OSS_MEM_ALLOC );
+
+        /* at least one tick, intervals are rounded to the tick */
+        rate  = OSS_TickRateGet( llHdl->osHdl );
+        ticks = intv / 1000 * rate + (intv % 1000 * rate + 500) / 1000;
+        if( !ticks )
+            ticks = 1;
+    }
+
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+    oldSum  = llHdl->sum;
+    oldSize = llHdl->sumSizeGot;
+    llHdl->sum        = sum;
+    llHdl->sumSizeGot = gotsize;
+    llHdl->sumIntv    = intv;
+    llHdl->sumTicks   = ticks;
+    llHdl->sumIn      = 0;
+    llHdl->sumOut     = 0;
+    llHdl->sumSeq     = 0;
+    llHdl->sumOpen    = FALSE;
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+
+    if( oldSum )
+        OSS_MemFree( llHdl->osHdl, (int8*)oldSum, oldSize );
+
+    return( ERR_SUCCESS );
+}
+
+/********************************* sumClose ********************************/
+/** Complete the current summary if its interval has ended
+ *
+ *  The oldest summary is overwritten when the ring is full. Must be called
+ *  with the interrupt masked.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param now        \IN  current time [OSS ticks]
+ */
+static void sumClose( LL_HANDLE* llHdl, u_int32 now )
+{
+    if( !llHdl->sumOpen || (int32)(now - llHdl->sumEnd) < 0 )
+        return;
+
+    llHdl->sumOpen = FALSE;
+    llHdl->sumIn   = (llHdl->sumIn + 1) % llHdl->sumDepth;
+    if( llHdl->sumIn == llHdl->sumOut )
+        llHdl->sumOut = (llHdl->sumOut + 1) % llHdl->sumDepth;
+}
+
+/********************************** sumGet *********************************/
+/** Get the summary of the current interval, start it if necessary
+ *
+ *  Intervals are aligned to multiples of the interval length, intervals
+ *  without activity are skipped. Must be called with the interrupt masked.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param pos        \IN  position before the change
+ *
+ *  \return           current summary
+ */
+static Z73_SUMMARY *sumGet( LL_HANDLE* llHdl, int32 pos )
+{
+    Z73_SUMMARY *s;
+    u_int32 now = OSS_TickGet( llHdl->osHdl );
+
+    sumClose( llHdl, now );
+    s = &llHdl->sum[llHdl->sumIn];
+
+    if( !llHdl->sumOpen )
+    {
+        s->start    = now - now % llHdl->sumTicks;
+        s->seq      = llHdl->sumSeq++;
+        s->pos      = pos;
+        s->delta    = 0;
+        s->posMin   = pos;
+        s->posMax   = pos;
+        s->presses  = 0;
+        s->releases = 0;
+        s->peakVel  = 0;
+        llHdl->sumEnd  = s->start + llHdl->sumTicks;
+        llHdl->sumOpen = TRUE;
+    }
+
+    return( s );
+}
+
+/********************************** sumPos *********************************/
+/** Add a count change to the current summary
+ *
+ *  The velocity is taken between the previous and this count change.
+ *  Must be called from readPosCnt() before the change is stored in the
+ *  position history.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param delta      \IN  counts read, already added to posAcc
+ *  \param ts         \IN  timestamp of the change [Z73_TIMESTAMP]
+ */
+static void sumPos( LL_HANDLE* llHdl, int32 delta, u_int32 ts )
+{
+    Z73_SUMMARY *s = sumGet( llHdl, llHdl->posAcc - delta );
+    u_int32 dp, dt, vel;
+
+    s->pos    = llHdl->posAcc;
+    s->delta += delta;
+    if( llHdl->posAcc < s->posMin )
+        s->posMin = llHdl->posAcc;
+    if( llHdl->posAcc > s->posMax )
+        s->posMax = llHdl->posAcc;
+
+    if( llHdl->posHistCnt && !posHistStale( llHdl ) )
+    {
+        dp = (u_int32)(delta < 0 ? -delta : delta);
+        if( dp > Z73_PHIST_DPMAX )
+            dp = Z73_PHIST_DPMAX;
+        dt = ts - llHdl->posHist[(llHdl->posHistIn + Z73_PHIST_NUM - 1) %
+                                 Z73_PHIST_NUM].tick;
+        vel = (dp << 16) / (dt ? dt : 1);
+        if( vel > s->peakVel )
+            s->peakVel = vel;
+    }
+}
+
+/********************************* devReset ********************************/
+/** Reset the device state without close/open
+ *
+ *  Everything is done with the interrupt masked, so no event is seen
+ *  half reset: the counter is read and the counts not yet reported are
+ *  discarded, the queues (and deferred snapshots) are flushed or kept,
+ *  (a gesture in progress is dropped), the position is set, pending interrupts and the
+ *  error state are cleared and the configured interrupts are enabled
+ *  again. Queues, signals and alarms stay allocated.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param flags      \IN  Z073_RESET_xxx
+ *  \param pos        \IN  new position if Z073_RESET_POS
+ *
+ *  \return           \c 0 on success or ERR_LL_ILL_PARAM for unknown flags
+ */
+static int32 devReset( LL_HANDLE* llHdl, u_int32 flags, int32 pos )
+{
+    OSS_IRQ_STATE irqState;
+
+    if( flags & ~(Z073_RESET_FLUSH | Z073_RESET_POS) )
+        return( ERR_LL_ILL_PARAM );
+
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+    llHdl->irqOn = FALSE;
+    irqArm( llHdl );
+
+    readPosCnt( llHdl );
+    llHdl->posPending = 0;
+    llHdl->posMoved   = FALSE;
+    llHdl->moveIrq    = FALSE;
+
+    if( flags & Z073_RESET_FLUSH )
+    {
+        qFlush( &llHdl->btnQ );
+        qFlush( &llHdl->movQ );
+        llHdl->rawQOut = llHdl->rawQIn;
+        sigRearm( llHdl );
+
+        /* a gesture would be completed by the flushed entries */
+        llHdl->gestState = Z73_GEST_IDLE;
+        if( llHdl->gestAlarm )
+            gestureArm( llHdl, 0, FALSE );
+    }
+
+    if( flags & Z073_RESET_POS )
+    {
+        /* summaries don't span the position jump */
+        if( llHdl->sum )
+            sumClose( llHdl, llHdl->sumEnd );
+
+        llHdl->warmBase  += pos - llHdl->posAcc;
+        llHdl->posAcc     = pos;
+        llHdl->wdogPos    = pos;
+        llHdl->posHistCnt = 0;
+    }
+
+    Z73_WR( llHdl, Z073_IRQ, 0xFFFFFFFF );
+    llHdl->irqOn = TRUE;
+    irqArm( llHdl );
+
+    Z73_TRC( llHdl, Z073_TRC_RESET, flags, llHdl->posAcc );
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+
+    return( ERR_SUCCESS );
+}
+
+/********************************** qFlush *********************************/
+/** Discard all entries of a status queue
+ *
+ *  Must be called with the interrupt masked.
+ *
+ *  \param q          \IN  queue
+ */
+static void qFlush( Z73_QUEUE *q )
+{
+    q->out    = q->in;
+    q->cnt    = 0;
+    q->keyCnt = 0;
+    q->hwm    = 0;
+}
+
+/******************************** warmRestore ******************************/
+/** Take over the position at Z73_Init()
+ *
+ *  Without Z073_WARM_START the hardware counter is cleared and the
+ *  position starts at 0. Otherwise the counts accumulated while the
+ *  driver was closed are read and added to the checkpoint stored by
+ *  Z73_Exit() under the same id, if there is one. The id is reserved
+ *  until the device is closed, another open device with the same id is
+ *  rejected. Interrupts must be disabled.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *
+ *  \return           \c 0 on success or ERR_LL_ILL_PARAM (id in use)
+ */
+static int32 warmRestore( LL_HANDLE* llHdl )
+{
+    Z73_CKPT *cp = NULL, *freeCp = NULL;
+    u_int32 i;
+
+    if( !llHdl->warmStart )
+    {
+        Z73_RD( llHdl, Z073_POS_CNT );
+        return( ERR_SUCCESS );
+    }
+
+    /* entry of this id, else a free one */
+    for( i = 0; i < Z73_CKPT_NUM; i++ )
+    {
+        if( G_ckpt[i].id == llHdl->warmStart )
+            cp = &G_ckpt[i];
+        else if( !G_ckpt[i].id && !freeCp )
+            freeCp = &G_ckpt[i];
+    }
+
+    if( cp && cp->open )
+    {
+        DBGWRT_ERR((DBH, "*** LL - Z73_Init: Z073_WARM_START id %d in use\n",
+                    (int)llHdl->warmStart));
+        return( ERR_LL_ILL_PARAM );
+    }
+
+    if( !cp && (cp = freeCp) != NULL )
+    {
+        cp->id   = llHdl->warmStart;
+        cp->used = FALSE;
+    }
+
+    /* counts of the closed time belong to the checkpoint, no movement */
+    readPosCnt( llHdl );
+    llHdl->warmBase   = -llHdl->posAcc;
+    llHdl->posAcc     = 0;
+    llHdl->posPending = 0;
+    llHdl->posMoved   = FALSE;
+    llHdl->posHistCnt = 0;
+
+    if( cp )
+    {
+        if( cp->used )
+            ckptApply( llHdl, cp->pos, cp->inputs );
+        cp->used = FALSE;
+        cp->open = TRUE;
+    } else
+    {
+        DBGWRT_ERR((DBH, "*** LL - Z73_Init: no free checkpoint\n"));
+    }
+    llHdl->ckpt = cp;
+
+    DBGWRT_1((DBH, "LL - Z73_Init: warm start %d pos=%d\n",
+              (int)llHdl->warmState, (int)llHdl->posAcc));
+    return( ERR_SUCCESS );
+}
+
+/********************************* warmSave ********************************/
+/** Store the position at Z73_Exit() for the next Z73_Init()
+ *
+ *  Interrupts must be disabled.
+ *
+ *  \param llHdl      \IN  low-level handle
+ */
+static void warmSave( LL_HANDLE* llHdl )
+{
+    Z73_CKPT *cp = llHdl->ckpt;
+
+    /* no entry was free at Z73_Init() */
+    if( !cp )
+        return;
+
+    readPosCnt( llHdl );
+    cp->pos    = llHdl->posAcc;
+    cp->inputs = Z73_RD( llHdl, Z073_IRQ );
+    cp->used   = TRUE;
+}
+
+/********************************* ckptApply *******************************/
+/** Restore a checkpoint
+ *
+ *  The counts read since the checkpoint was taken are added to its
+ *  position. The quadrature phase of the A/B inputs must have moved by
+ *  the same counts, otherwise the encoder moved unobserved (power loss,
+ *  counter overflow) and the checkpoint is rejected. As for a position
+ *  reset, an open summary interval is closed and the watchdog restarts
+ *  from the new position. Must be called with the interrupt masked, after
+ *  readPosCnt().
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param pos        \IN  position of the checkpoint
+ *  \param inputs     \IN  Z073_IRQ input levels of the checkpoint
+ *
+ *  \return           \c 0 on success or Z073_ERR_CKPT_MISMATCH
+ */
+static int32 ckptApply( LL_HANDLE* llHdl, int32 pos, u_int32 inputs )
+{
+    int32 delta = llHdl->posAcc - llHdl->warmBase;
+
+    if( ((Z73_PHASE( inputs ) + (u_int32)delta) & 3) !=
+        (u_int32)Z73_PHASE( Z73_RD( llHdl, Z073_IRQ ) ) )
+    {
+        llHdl->warmState = Z073_WARM_MISMATCH;
+        return( Z073_ERR_CKPT_MISMATCH );
+    }
+
+    /* summaries don't span the position jump */
+    if( llHdl->sum )
+        sumClose( llHdl, llHdl->sumEnd );
+
+    llHdl->posAcc     = pos + delta;
+    llHdl->warmBase   = pos;
+    llHdl->wdogPos    = llHdl->posAcc;
+    llHdl->posHistCnt = 0;
+    llHdl->warmState  = Z073_WARM_RESTORED;
+
+    return( ERR_SUCCESS );
+}
+
+/****************************** posHistStale *******************************/
+/** Check if the newest position sample is older than half the timestamp
+ *  range
+ *
+ *  The cycle counter timestamp wraps after about an hour, so the age of
+ *  the history is also checked with the system tick.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *
+ *  \return           TRUE if timestamp differences to the history are
+ *                    no longer valid
+ */
+static int32 posHistStale( LL_HANDLE* llHdl )
+{
+    u_int32 rate = Z73_TIMESTAMP_RATE( llHdl );
+    u_int32 osRate = OSS_TickRateGet( llHdl->osHdl );
+
+    if( !rate || !osRate )
+        return( FALSE );
+
+    return( (OSS_TickGet( llHdl->osHdl ) - llHdl->posHistOs) / osRate >=
+            0x7fffffff / rate );
+}
+
+/******************************** posExtrap ********************************/
+/** Position at a target time from the timestamped position history
+ *
+ *  The counter is read first, so the position up to the time of the call
+ *  is exact. A target in the past is interpolated between the samples, a
+ *  target in the future is extrapolated with the mean velocity of the
+ *  newest samples. The sample window ends at a gap which is long compared
+ *  to the newer samples (motion started again) and the horizon is limited
+ *  to the length of the window. When no count arrived for more than two
+ *  expected count intervals the encoder is taken as stationary and the
+ *  velocity is 0. Only 32 bit integer math is used. The resolution is
+ *  the one of Z73_TIMESTAMP; a history older than half the timestamp
+ *  range is handled as if the last count change was a quarter range ago.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param px         \IN  mode, target
+ *                    \OUT results
+ */
+static void posExtrap( LL_HANDLE* llHdl, Z73_POS_EXTRAP *px )
+{
+    OSS_IRQ_STATE irqState;
+    Z73_PSAMPLE hist[Z73_PHIST_NUM];    /* newest first */
+    u_int32 n, i, idx, used, tN, dt = 0, idle, horizon, ival, still;
+    int32 pN, dp = 0, dpStep;
+
+    /* fresh counter value and a copy of the history */
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+    readPosCnt( llHdl );
+    px->now     = Z73_TIMESTAMP( llHdl );
+    px->posRead = llHdl->posAcc;
+    n   = llHdl->posHistCnt;
+    idx = llHdl->posHistIn;
+    for( i = 0; i < n; i++ )
+    {
+        idx = (idx + Z73_PHIST_NUM - 1) % Z73_PHIST_NUM;
+        hist[i] = llHdl->posHist[idx];
+    }
+    /* older than the timestamp can tell: move it to a quarter of the
+     * range, leaving room for a target in the future */
+    if( n && posHistStale( llHdl ) )
+    {
+        tN = hist[0].tick - (px->now - 0x3fffffff);
+        for( i = 0; i < n; i++ )
+            hist[i].tick -= tN;
+    }
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+
+    px->tickRate = Z73_TIMESTAMP_RATE( llHdl );
+    if( px->mode == Z073_EXTRAP_NOW )
+        px->target = px->now;
+
+    /* newest count change, the call itself if the encoder never moved */
+    tN = n ? hist[0].tick : px->now;
+    pN = px->posRead;
+    idle = px->now - tN;
+    px->age = (int32)(px->target - tN);
+
+    /* sample window */
+    for( used = 1; used < n; used++ )
+    {
+        if( used > 1 &&
+            hist[used-1].tick - hist[used].tick >
+            2 * (tN - hist[used-1].tick) + 1 )
+            break;
+        if( pN - hist[used].pos > Z73_PHIST_DPMAX ||
+            pN - hist[used].pos < -Z73_PHIST_DPMAX )
+            break;
+    }
+    if( used > 1 )
+    {
+        dt = tN - hist[used-1].tick;
+        dp = pN - hist[used-1].pos;
+        if( dt == 0 )
+            dt = 1;             /* below timestamp resolution */
+    }
+
+    /* stationary if two expected counts are missing */
+    still = TRUE;
+    if( dp )
+    {
+        ival = dt / (u_int32)(dp < 0 ? -dp : dp);
+        still = idle > 2 * ival + 1;
+    }
+
+    px->pos   = pN;
+    px->vel   = still ? 0 : dp * 0x10000 / (int32)dt;
+    px->conf  = Z073_EXTRAP_CONF_MAX;
+    px->flags = still ? Z073_EXTRAP_STILL : 0;
+
+    if( n && (int32)(px->target - tN) < 0 )
+    {
+        /* past: interpolate between the samples around the target */
+        for( i = 0; i < n; i++ )
+            if( (int32)(px->target - hist[i].tick) >= 0 )
+                break;
+
+        if( i == n )
+        {
+            px->pos   = n ? hist[n-1].pos : pN;
+            px->conf  = 0;
+            px->flags |= Z073_EXTRAP_PAST;
+        }
+        else
+        {
+            dpStep = hist[i-1].pos - hist[i].pos;
+            px->pos = hist[i].pos;
+            if( dpStep <= Z73_PHIST_DPMAX && dpStep >= -Z73_PHIST_DPMAX )
+                px->pos += scaleDiv( dpStep, px->target - hist[i].tick,
+                                     hist[i-1].tick - hist[i].tick );
+        }
+    }
+    else if( (int32)(px->target - px->now) > 0 )
+    {
+        /* future: predict */
+        horizon = px->target - px->now;
+        px->flags |= Z073_EXTRAP_PREDICT;
+
+        if( still )
+        {
+            /* the longer it stood still, the more likely it stays */
+            px->conf = scaleDiv( Z073_EXTRAP_CONF_MAX, idle,
+                                 satAdd( idle, horizon ) );
+        }
+        else
+        {
+            if( (u_int32)px->age > dt )
+            {
+                px->age = (int32)dt;
+                px->flags |= Z073_EXTRAP_CLAMPED;
+            }
+            px->pos += scaleDiv( dp, (u_int32)px->age, dt );
+            px->age  = (int32)(px->target - tN);
+
+            /* more samples and a short horizon give a better estimate */
+            px->conf = scaleDiv( scaleDiv( Z073_EXTRAP_CONF_MAX, used - 1,
+                                           Z73_PHIST_NUM - 1 ),
+                                 dt, satAdd( dt, horizon ) );
+
+            /* newest step against the window direction */
+            dpStep = hist[0].pos - hist[1].pos;
+            if( (dpStep < 0) != (dp < 0) )
+                px->conf /= 2;
+        }
+    }
+    /* else: no count change between tN and now, pos is exact */
+}
+
+/********************************* scaleDiv ********************************/
+/** Compute a * b / c in 32 bit
+ *
+ *  b and c are reduced until the product fits, which costs only the
+ *  precision lost by the timestamp resolution.
+ *
+ *  \param a          \IN  value, |a| <= Z73_PHIST_DPMAX
+ *  \param b          \IN  numerator, limited to c
+ *  \param c          \IN  denominator
+ *
+ *  \return           a * b / c, 0 if c is 0
+ */
+static int32 scaleDiv( int32 a, u_int32 b, u_int32 c )
+{
+    if( c == 0 )
+        return( 0 );
+    if( b > c )
+        b = c;
+
+    while( c > 0xffff )
+    {
+        b >>= 1;
+        c >>= 1;
+    }
+
+    return( a * (int32)b / (int32)c );
+}
+
+/********************************** satAdd *********************************/
+/** Add two time spans, saturated at the u_int32 range
+ *
+ *  \param a          \IN  first span
+ *  \param b          \IN  second span
+ *
+ *  \return           a + b, 0xffffffff on overflow
+ */
+static u_int32 satAdd( u_int32 a, u_int32 b )
+{
+    return( a + b < a ? 0xffffffff : a + b );
+}
+
+#ifdef Z73_TRACE
+/********************************* trcWrite ********************************/
+/** Write a record to the trace ring, the oldest record is overwritten
+ *  when the ring is full
+ *
+ *  Must be called with the interrupt masked. Use the Z73_TRC() macro,
+ *  which compiles to nothing without Z73_TRACE.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param id         \IN  \ref trace_ids "record id"
+ *  \param a          \IN  first value
+ *  \param b          \IN  second value
+ */
+static void trcWrite( LL_HANDLE* llHdl, u_int16 id, u_int32 a, u_int32 b )
+{
+    Z73_TRC_REC *rec = &llHdl->trc[llHdl->trcIn];
+
+    rec->ts  = Z73_TIMESTAMP( llHdl );
+    rec->id  = id;
+    rec->seq = llHdl->trcSeq++;
+    rec->a   = a;
+    rec->b   = b;
+
+    llHdl->trcIn = (llHdl->trcIn + 1) % Z73_TRC_DEPTH;
+    if( llHdl->trcIn == llHdl->trcOut )
+        llHdl->trcOut = (llHdl->trcOut + 1) % Z73_TRC_DEPTH;
+}
+#endif /* Z73_TRACE */
+
+#ifdef Z73_MMIO_LOG
+/********************************* mmioRead ********************************/
+/** Read a register and log the access
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param off        \IN  register offset
+ *
+ *  \return           register value
+ */
+static u_int32 mmioRead( LL_HANDLE* llHdl, u_int32 off )
+{
+    u_int32 val = MREAD_D32( llHdl->ma, off );
+
+    mmioRec( llHdl, Z073_MMIO_RD, off, val );
+    return( val );
+}
+
+/********************************* mmioWrite *******************************/
+/** Write a register and log the access
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param off        \IN  register offset
+ *  \param val        \IN  value
+ */
+static void mmioWrite( LL_HANDLE* llHdl, u_int32 off, u_int32 val )
+{
+    MWRITE_D32( llHdl->ma, off, val );
+    mmioRec( llHdl, Z073_MMIO_WR, off, val );
+}
+
+/********************************* mmioApi *********************************/
+/** Log a Read/GetStat/SetStat call
+ *
+ *  For block codes the block size and the first Z073_MMIO_DATA_MAX bytes
+ *  of the block are logged, so the replayer can pass the same input.
+ *  Reading the log itself (Z073_BLK_MMIO) is not logged.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param type       \IN  Z073_MMIO_READ/GETSTAT/SETSTAT
+ *  \param code       \IN  status code or channel
+ *  \param arg        \IN  SetStat value or block pointer
+ */
+static void mmioApi(
+    LL_HANDLE* llHdl,
+    u_int16 type,
+    int32 code,
+    INT32_OR_64 arg )
+{
+    M_SG_BLOCK *blk = (M_SG_BLOCK*)arg;
+    u_int32 off, word, len;
+
+    if( (u_int32)code == Z073_BLK_MMIO )
+        return;
+
+    if( type == Z073_MMIO_READ || !Z73_IS_BLK( code ) )
+    {
+        mmioRec( llHdl, type, (u_int32)code,
+                 type == Z073_MMIO_SETSTAT ? (u_int32)arg : 0 );
+        return;
+    }
+
+    mmioRec( llHdl, type, (u_int32)code, (u_int32)blk->size );
+
+    len = (u_int32)blk->size < Z073_MMIO_DATA_MAX ?
+          (u_int32)blk->size : Z073_MMIO_DATA_MAX;
+    for( off = 0; off + 4 <= len; off += 4 )
+    {
+        OSS_MemCopy( llHdl->osHdl, 4, (char*)blk->data + off, (char*)&word );
+        mmioRec( llHdl, Z073_MMIO_DATA, off, word );
+    }
+}
+
+/********************************* mmioRec *********************************/
+/** Write a record to the register access log
+ *
+ *  Called from all contexts. When the log is full new records are
+ *  dropped, so a replay always starts at Z073_MMIO_START; the number of
+ *  dropped records is logged as Z073_MMIO_LOST when space is available.
+ *  Each record carries the id of the current task, so the replayer can
+ *  separate calls of several tasks which overlap in the log.
+ *
+ *  \param llHdl      \IN  low-level handle
+ *  \param type       \IN  record type (Z073_MMIO_xxx)
+ *  \param a          \IN  first value
+ *  \param b          \IN  second value
+ */
+static void mmioRec( LL_HANDLE* llHdl, u_int16 type, u_int32 a, u_int32 b )
+{
+    OSS_IRQ_STATE irqState;
+    Z73_MMIO_REC *rec;
+    u_int32 free, tid = OSS_GetPid( llHdl->osHdl );
+
+    irqState = OSS_IrqMaskR( llHdl->osHdl, llHdl->irqHdl );
+
+    free = (llHdl->mmioOut + Z73_MMIO_DEPTH - llHdl->mmioIn - 1) %
+           Z73_MMIO_DEPTH;
+
+    if( free < (llHdl->mmioLost ? 2U : 1U) )
+    {
+        llHdl->mmioLost++;
+    } else
+    {
+        if( llHdl->mmioLost )
+        {
+            rec = &llHdl->mmio[llHdl->mmioIn];
+            rec->ts   = Z73_TIMESTAMP( llHdl );
+            rec->type = Z073_MMIO_LOST;
+            rec->seq  = llHdl->mmioSeq++;
+            rec->a    = llHdl->mmioLost;
+            rec->b    = 0;
+            rec->tid  = tid;
+            llHdl->mmioIn = (llHdl->mmioIn + 1) % Z73_MMIO_DEPTH;
+            llHdl->mmioLost = 0;
+        }
+
+        rec = &llHdl->mmio[llHdl->mmioIn];
+        rec->ts   = Z73_TIMESTAMP( llHdl );
+        rec->type = type;
+        rec->seq  = llHdl->mmioSeq++;
+        rec->a    = a;
+        rec->b    = b;
+        rec->tid  = tid;
+        llHdl->mmioIn = (llHdl->mmioIn + 1) % Z73_MMIO_DEPTH;
+    }
+
+    OSS_IrqRestore( llHdl->osHdl, llHdl->irqHdl, irqState );
+}
+#endif /* Z73_MMIO_LOG */
 
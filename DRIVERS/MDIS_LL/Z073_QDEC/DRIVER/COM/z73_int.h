@@ -11,6 +11,8 @@
  *    \switches  _ONE_NAMESPACE_PER_DRIVER_
  *               _LL_DRV_
  *               Z73_POSCNT_24
+ *               Z73_TRACE (binary trace ring)
+ *               Z73_MMIO_LOG (register access log for offline replay)
  *
  *
  *---------------------------------------------------------------------------
@@ -56,12 +58,194 @@
 |  DEFINES                                 |
 +-----------------------------------------*/
 /* general defines */
-#define CH_NUMBER           1           /**< number of device channels */
+#define CH_NUMBER           3           /**< number of device channels */
 #define USE_IRQ             TRUE        /**< interrupt required  */
 #define ADDRSPACE_COUNT     1           /**< nbr of required address spaces */
 #define ADDRSPACE_SIZE      16          /**< size of address space */
 
-#define Z073_STATUSQ_SIZE_DEF 0x10      /**< default size of status queue */
+#define Z073_STATUSQ_SIZE_DEF 0x10      /**< default size of movement queue */
+#define Z073_BTNQ_SIZE_DEF  8           /**< default size of button queue */
+#define Z073_STATUSQ_QUIET_DEF 10000    /**< default quiet time [ms] before
+                                             an adaptive queue shrinks */
+#define Z73_Q_MAX           0x10000     /**< max. depth of a status queue
+                                             (also Z073_STATUSQ_MAX) */
+#define Z73_EVTSIG_MAX      9           /**< = Z073_EVTSIG_NUM (z73_drv.h) */
+#define Z73_RAWQ_SIZE       16          /**< irq snapshots for deferred mode,
+                                             the ISR processes the oldest
+                                             when full */
+
+/* gesture defaults [ms] */
+#define Z073_GEST_LONG_DEF      500     /**< default long press time */
+#define Z073_GEST_DBLCLICK_DEF  300     /**< default double click window */
+#define Z073_GEST_REPEAT_DEF    0       /**< default auto repeat (off) */
+
+/** \name signal flags for notification */
+/**@{*/
+#define Z73_SIGF_PRSREL         0x01    /**< press/release signal */
+#define Z73_SIGF_MOVE           0x02    /**< move signal */
+#define Z73_SIGF_GEST           0x04    /**< gesture signal */
+#define Z73_SIGF_READY          0x08    /**< ready signal */
+/**@}*/
+
+/** \name compact queue storage (delta records) */
+/**@{*/
+#define Z73_CQ_SHORT        2           /**< size of short record */
+#define Z73_CQ_FULL         13          /**< size of full record */
+#define Z73_CQ_ESC          0x80        /**< first byte of full record */
+#define Z73_CQ_KEYINT       64          /**< short records between keyframes */
+#define Z73_CQ_TMAX         0x1F        /**< max. tick delta of short record */
+#define Z73_CQ_INPUTS       (Z073_STATUS_PRESS_N | Z073_STATUS_INPUT_B | \
+                             Z073_STATUS_INPUT_A)
+/**@}*/
+
+/** \name event queues, one field is never filled to distinguish full/empty */
+/**@{*/
+#define Z73_Q_USED(q)       (((q)->in + (q)->depth - (q)->out) % (q)->depth)
+#define Z73_Q_FILL(q)       ((q)->compact ? (q)->cnt : Z73_Q_USED( q ))
+#define Z73_Q_FULL(q)       ((q)->compact ? \
+                             (q)->depth - 1 - Z73_Q_USED( q ) < Z73_CQ_FULL : \
+                             (((q)->in + 1) % (q)->depth) == (q)->out)
+#define Z73_Q_EMPTY(q)      ((q)->in == (q)->out)
+/** storage fields needed for n entries */
+#define Z73_Q_SIZE(q,n)     ((q)->compact ? (n) * Z73_CQ_SHORT + Z73_CQ_FULL : (n))
+/** depth in entries (nominal for compact storage) */
+#define Z73_Q_DEPTH(q)      ((q)->compact ? \
+                             ((q)->depth - Z73_CQ_FULL) / Z73_CQ_SHORT : \
+                             (q)->depth)
+/**@}*/
+
+/** number of entries in both status queues */
+#define Z73_STATUSQ_FILL(h) (Z73_Q_FILL( &(h)->btnQ ) + \
+                             Z73_Q_FILL( &(h)->movQ ))
+
+/** both status queues empty ? */
+#define Z73_STATUSQ_EMPTY(h) (Z73_Q_EMPTY( &(h)->btnQ ) && \
+                              Z73_Q_EMPTY( &(h)->movQ ))
+
+/** interrupts needed regardless of the queue fill (Z073_IRQ_DEMAND):
+ *  somebody waits, a signal is installed or the ISR does timing work */
+#define Z73_IRQ_NEEDED(h)   ((h)->waitCnt || (h)->prsRelSig || \
+                             (h)->upDwnSig || (h)->gestSig || \
+                             (h)->readySig || (h)->evtSig[0] || \
+                             (h)->gestEn || (h)->cap || (h)->sum)
+
+/** device ready ? (status queued or unreported movement) */
+#define Z73_READY(h)    (!Z73_STATUSQ_EMPTY( h ) || (h)->moveIrq)
+
+/** \name gesture state machine states */
+/**@{*/
+#define Z73_GEST_IDLE           0       /**< button released */
+#define Z73_GEST_PRESSED        1       /**< first press, waiting */
+#define Z73_GEST_LONG           2       /**< long press active */
+#define Z73_GEST_WAIT_DBL       3       /**< released, waiting for 2nd press */
+#define Z73_GEST_PRESSED2       4       /**< second press of double click */
+/**@}*/
+/** range of the count field of a Z073_STATUS word */
+#define Z73_STATUS_CNT_MAX  ((int32)(Z073_STATUS_CNT >> 1))
+#define Z73_STATUS_CNT_MIN  (-Z73_STATUS_CNT_MAX - 1)
+
+/** wrap protection watchdog: default min. period [ms] and the counts
+ *  per period the period is adapted to (1/4 of the counter range leaves
+ *  margin for acceleration and late alarms) */
+#define Z73_WDOG_MIN_DEF    10
+#define Z73_WDOG_SAFE       ((u_int32)Z73_STATUS_CNT_MAX / 4)
+
+/** sign extended count field of a Z073_STATUS word */
+#define Z73_STATUS_CNT_GET(s) (((int32)(((s) & Z073_STATUS_CNT) << \
+                                Z073_POS_CNT_SHIFT)) >> Z073_POS_CNT_SHIFT)
+
+/** timestamp for trace, capture and position records, may be
+ *  overridden by the build. By default the CPU cycle counter (x86 TSC,
+ *  PowerPC time base) is used, scaled down to roughly 1 MHz and
+ *  calibrated against the system tick in Z73_Init(). Other CPUs use the
+ *  system tick. */
+#ifndef Z73_TIMESTAMP
+# if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#  define Z73_TS_SHIFT      12      /**< cycles per timestamp: 4096 */
+static __inline__ u_int32 z73TsCycles( void )
+{
+    u_int32 lo, hi;
+
+    __asm__ __volatile__( "rdtsc" : "=a" (lo), "=d" (hi) );
+    return( (hi << (32 - Z73_TS_SHIFT)) | (lo >> Z73_TS_SHIFT) );
+}
+# elif defined(__GNUC__) && (defined(__powerpc__) || defined(__PPC__))
+#  define Z73_TS_SHIFT      4       /**< time base ticks per timestamp */
+static __inline__ u_int32 z73TsCycles( void )
+{
+    u_int32 lo, hi, hi2;
+
+    do {
+        __asm__ __volatile__( "mftbu %0" : "=r" (hi) );
+        __asm__ __volatile__( "mftb %0"  : "=r" (lo) );
+        __asm__ __volatile__( "mftbu %0" : "=r" (hi2) );
+    } while( hi != hi2 );
+    return( (hi << (32 - Z73_TS_SHIFT)) | (lo >> Z73_TS_SHIFT) );
+}
+# endif
+# ifdef Z73_TS_SHIFT
+#  define Z73_TS_CYCLES             /**< rate from tsCalibrate() */
+#  define Z73_TIMESTAMP(h)          z73TsCycles()
+#  define Z73_TIMESTAMP_RATE(h)     ((h)->tsRate)
+#  define Z73_TS_CAL_MS     20      /**< min. calibration time [ms] */
+# else
+#  define Z73_TIMESTAMP(h)          OSS_TickGet( (h)->osHdl )
+#  define Z73_TIMESTAMP_RATE(h)     OSS_TickRateGet( (h)->osHdl )
+# endif
+#endif
+#ifndef Z73_TIMESTAMP_RATE
+# define Z73_TIMESTAMP_RATE(h) 0    /**< unknown for overridden source */
+#endif
+
+/* raw edge capture */
+#define Z73_CAP_MAX         0x10000 /**< max. records in capture ring */
+
+/* summaries */
+#define Z73_SUM_DEPTH_DEF   64      /**< default summaries kept */
+
+/* warm start */
+#define Z73_CKPT_NUM        8       /**< warm start ids known at a time */
+/** quadrature phase 0..3 of the A/B levels in a Z073_IRQ value */
+#define Z73_PHASE(irq)      ((((irq) & Z073_IRQ_STS_A) ? 2 : 0) + \
+                             ((((irq) & Z073_IRQ_STS_A) ? 1 : 0) ^ \
+                              (((irq) & Z073_IRQ_STS_B) ? 1 : 0)))
+
+/* position extrapolation */
+#define Z73_PHIST_NUM       8       /**< position samples kept */
+#define Z73_PHIST_DPMAX     0x7fff  /**< max. counts in sample window */
+
+/* binary trace */
+#ifdef Z73_TRACE
+# ifndef Z73_TRC_DEPTH
+#  define Z73_TRC_DEPTH     256         /**< trace records per device */
+# endif
+# define Z73_TRC(h,id,a,b)  trcWrite( (h), (id), (u_int32)(a), (u_int32)(b) )
+#else
+# define Z73_TRC(h,id,a,b)
+#endif
+
+/** block status code ? (M_xx_BLK_OF codes have bit 31 set) */
+#define Z73_IS_BLK(code)    ((u_int32)(code) & 0x80000000)
+
+/* register access, Z73_MMIO_LOG logs every access and every entry into
+ * the driver; the host replayer (TOOLS/Z73_REPLAY) defines its own */
+#ifndef Z73_RD
+# ifdef Z73_MMIO_LOG
+#  ifndef Z73_MMIO_DEPTH
+#   define Z73_MMIO_DEPTH   4096        /**< log records per device */
+#  endif
+#  define Z73_RD(h,off)         mmioRead( (h), (off) )
+#  define Z73_WR(h,off,v)       mmioWrite( (h), (off), (v) )
+#  define Z73_MMIO_EV(h,t,a)    mmioRec( (h), (t), (u_int32)(a), 0 )
+#  define Z73_MMIO_API(h,t,c,v) mmioApi( (h), (t), (c), (INT32_OR_64)(v) )
+# else
+#  define Z73_RD(h,off)         MREAD_D32( (h)->ma, (off) )
+#  define Z73_WR(h,off,v)       MWRITE_D32( (h)->ma, (off), (v) )
+#  define Z73_MMIO_EV(h,t,a)
+#  define Z73_MMIO_API(h,t,c,v)
+# endif
+#endif
+
 /* debug defines */
 #define DBG_MYLEVEL         llHdl->dbgLevel   /**< debug level */
 #define DBH                 llHdl->dbgHdl     /**< debug handle */
@@ -76,8 +260,10 @@
         /**< Status of position counter (changed/initial value) */
 #ifdef Z73_POSCNT_24
  #define Z073_POS_CNT_CNT       0x00FFFFFF
+ #define Z073_POS_CNT_SHIFT     8
 #else
  #define Z073_POS_CNT_CNT       0x0000FFFF
+ #define Z073_POS_CNT_SHIFT     16
 #endif
         /**<  State of position counter */
 #define Z073_IRQ_EN             0x08
@@ -123,6 +309,41 @@
 /*-----------------------------------------+
 |  TYPEDEFS                                |
 +-----------------------------------------*/
+/** timestamped position sample */
+typedef struct {
+    u_int32         tick;           /**< time of count change [Z73_TIMESTAMP]*/
+    int32           pos;            /**< position after the change */
+} Z73_PSAMPLE;
+
+/** checkpoint kept from Z73_Exit() to the next Z73_Init() of the device
+ *  with the same Z073_WARM_START id */
+typedef struct {
+    u_int32         id;             /**< Z073_WARM_START id, 0=entry free */
+    u_int32         open;           /**< device with this id is open */
+    u_int32         used;           /**< checkpoint stored */
+    int32           pos;            /**< accumulated position */
+    u_int32         inputs;         /**< Z073_IRQ input levels */
+} Z73_CKPT;
+
+/** status queue */
+typedef struct {
+    struct Z73_EVENT *ent;          /**< entries (depth), NULL if compact */
+    u_int8          *cbuf;          /**< records (depth bytes) if compact */
+    u_int32         sizeGot;        /**< size of block actually allocated */
+    u_int32         depth;          /**< number of entries/bytes */
+    u_int32         in;             /**< position of first free entry/byte */
+    u_int32         out;            /**< position of first filled entry/byte */
+    u_int32         hwm;            /**< max. fill since last check */
+    /* compact storage */
+    u_int32         compact;        /**< store delta records */
+    u_int32         cnt;            /**< number of records */
+    u_int32         keyCnt;         /**< short records since last keyframe */
+    u_int32         inTick;         /**< tick of newest record */
+    u_int32         inSeq;          /**< sequence number of newest record */
+    u_int32         outTick;        /**< tick of last record read */
+    u_int32         outSeq;         /**< sequence number of last record read */
+} Z73_QUEUE;
+
 /** low-level handle */
 typedef struct {
     /* general */
@@ -135,24 +356,140 @@ typedef struct {
     /* debug */
     u_int32         dbgLevel;       /**< debug level */
     DBG_HANDLE      *dbgHdl;        /**< debug handle */
+#ifdef Z73_TRACE
+    /* binary trace */
+    struct Z73_TRC_REC *trc;        /**< trace ring (Z73_TRC_DEPTH records)*/
+    u_int32         trcSizeGot;     /**< size of trace ring allocated */
+    u_int32         trcIn;          /**< first free record */
+    u_int32         trcOut;         /**< oldest record */
+    u_int16         trcSeq;         /**< next sequence number */
+#endif
+#ifdef Z73_MMIO_LOG
+    /* register access log */
+    struct Z73_MMIO_REC *mmio;      /**< log ring (Z73_MMIO_DEPTH records) */
+    u_int32         mmioSizeGot;    /**< size of log ring allocated */
+    u_int32         mmioIn;         /**< first free record */
+    u_int32         mmioOut;        /**< oldest record */
+    u_int32         mmioLost;       /**< records lost since last LOST */
+    u_int16         mmioSeq;        /**< next sequence number */
+#endif
+    /* locking: state shared with the ISR is protected by masking the
+     * interrupt, configuration changes are serialized by cfgSem */
+    OSS_SEM_HANDLE  *cfgSem;        /**< serializes SetStat calls */
     /* misc */
     u_int32         irqCount;       /**< interrupt counter */
+
+    /* raw edge capture */
+    struct Z73_CAP_REC *cap;        /**< capture ring, NULL if off */
+    u_int32         capSizeGot;     /**< size of capture ring allocated */
+    u_int32         capDepth;       /**< records in capture ring */
+    u_int32         capIn;          /**< first free record */
+    u_int32         capOut;         /**< oldest record */
+    u_int32         capSeq;         /**< next sequence number */
     u_int32         irqEn;          /**< interrupts to enable */
+    u_int32         irqOn;          /**< interrupts enabled (M_MK_IRQ_ENABLE)*/
+    u_int32         irqArmed;       /**< causes enabled in hardware */
+    u_int32         irqDemand;      /**< unread entries budget, 0=off */
+
+    /* interval summaries */
+    struct Z73_SUMMARY *sum;        /**< summary ring, NULL if off */
+    u_int32         sumSizeGot;     /**< size of summary ring allocated */
+    u_int32         sumDepth;       /**< summaries in ring */
+    u_int32         sumIn;          /**< current summary */
+    u_int32         sumOut;         /**< oldest completed summary */
+    u_int32         sumSeq;         /**< next sequence number */
+    u_int32         sumIntv;        /**< interval [ms], 0=off */
+    u_int32         sumTicks;       /**< interval [OSS ticks] */
+    u_int32         sumEnd;         /**< end of current interval */
+    u_int32         sumOpen;        /**< current summary started */
 
     OSS_SIG_HANDLE  *prsRelSig;     /**< signal f. button press/release events*/
     OSS_SIG_HANDLE  *upDwnSig;      /**< signal f. button move events*/
 
-    /* status data queue */
-    u_int32         *statusQ;       /**< FIFO for status */
-                                    /*!< filled when push button events are
-                                     *   detected */
-    u_int32         statusQIn;      /**< position of first free field in Q */
-    u_int32         statusQOut;     /**< position of first filled field in Q */
-    u_int32         statusQDepth;       /**< depth of Q */
+    /* status data queues */
+    Z73_QUEUE       btnQ;           /**< press/release/gesture entries */
+    Z73_QUEUE       movQ;           /**< movement entries, coalesced if full */
+    u_int32         qOrder;         /**< read order (Z073_QORDER_xxx) */
+    u_int32         evSeq;          /**< sequence number of next entry */
+    u_int32         btnDropped;     /**< entries dropped, btnQ was full */
+    u_int32         movQBase;       /**< configured depth of movQ */
+    u_int32         qAdaptMax;      /**< adaptive movQ: max. depth, 0=off */
+    u_int32         qAdaptQuiet;    /**< adaptive movQ: quiet time [ms] */
+    u_int32         qBusyTick;      /**< adaptive movQ: last busy check */
+    u_int8          *qSpare;        /**< adaptive movQ: buffer for the next
+                                         grow step, NULL=none */
+    u_int32         qSpareGot;      /**< size of qSpare allocated */
+    u_int32         qSpareDepth;    /**< entries/bytes of qSpare */
+    u_int8          *qOld;          /**< buffer replaced by qGrowAlarm,
+                                         freed by qSpareGet() */
+    u_int32         qOldGot;        /**< size of qOld allocated */
+    u_int32         qGrowArmed;     /**< qGrowAlarm running */
+    OSS_ALARM_HANDLE *qGrowAlarm;   /**< grows movQ while nobody reads */
+
+    /* deferred interrupt processing */
+    u_int32         deferred;       /**< process irqs outside of ISR */
+    u_int32         rawQ[Z73_RAWQ_SIZE]; /**< Z073_IRQ snapshots from ISR */
+    u_int32         rawQIn;         /**< first free field in rawQ */
+    u_int32         rawQOut;        /**< first filled field in rawQ */
+    u_int32         deferArmed;     /**< deferAlarm running */
+    OSS_ALARM_HANDLE *deferAlarm;   /**< alarm for deferred processing */
+
+    /* position */
+    int32           posAcc;         /**< accumulated position (all deltas
+                                         read from Z073_POS_CNT) */
+    int32           posPending;     /**< delta read but not yet reported */
+    u_int32         posMoved;       /**< movement seen since last report */
+    Z73_PSAMPLE     posHist[Z73_PHIST_NUM]; /**< last count changes */
+    u_int32         posHistIn;      /**< next field in posHist */
+    u_int32         posHistCnt;     /**< valid fields in posHist */
+    u_int32         posHistOs;      /**< OSS tick of the newest posHist
+                                         field, detects timestamp wrap */
+    u_int32         tsRate;         /**< Z73_TIMESTAMP rate [Hz] of the
+                                         cycle counter, 0=unknown */
+
+    /* wrap protection watchdog */
+    u_int32         wdogMax;        /**< max. period [ms], 0=off */
+    u_int32         wdogMin;        /**< min. period [ms] */
+    u_int32         wdogMs;         /**< current period [ms] */
+    int32           wdogPos;        /**< posAcc at the last run */
+    OSS_ALARM_HANDLE *wdogAlarm;    /**< alarm of the watchdog */
 
-    int32           statusQSizeGot; /**< size of block actually allocated */
+    /* warm start */
+    u_int32         warmStart;      /**< checkpoint id, 0=off */
+    Z73_CKPT        *ckpt;          /**< checkpoint entry, NULL=none */
+    u_int32         warmState;      /**< result (Z073_WARM_xxx) */
+    int32           warmBase;       /**< posAcc - counts read since the
+                                         checkpoint */
 
-    int32           error;          /**< error detected, transmitted first */
+    /* gesture recognition */
+    u_int32         gestEn;         /**< gesture recognition enabled */
+    u_int32         gestLongMs;     /**< long press time [ms], 0=off */
+    u_int32         gestDblMs;      /**< double click window [ms], 0=off */
+    u_int32         gestRepMs;      /**< auto repeat period [ms], 0=off */
+    u_int32         gestState;      /**< state machine state (Z73_GEST_xxx) */
+    OSS_ALARM_HANDLE *gestAlarm;    /**< alarm for gesture timing */
+    OSS_SIG_HANDLE  *gestSig;       /**< signal f. gesture events */
+
+    /* signal notification */
+    u_int32         sigMode;        /**< notification mode (Z073_SIGMODE_xxx)*/
+    u_int32         sigWatermark;   /**< queue fill to reach before signal */
+    u_int32         sigMaxLat;      /**< max. signal latency [ms], 0=off */
+    u_int32         sigPend;        /**< signals held back (Z73_SIGF_xxx) */
+    u_int32         sigSent;        /**< signals sent since queue was read */
+    u_int32         sigLatArmed;    /**< latency alarm running */
+    OSS_ALARM_HANDLE *sigLatAlarm;  /**< alarm for max. signal latency */
+
+    /* readiness */
+    u_int32         moveIrq;        /**< move irq since last status report */
+    OSS_SIG_HANDLE  *readySig;      /**< signal f. device becomes ready */
+    OSS_SEM_HANDLE  *readySem;      /**< wakes Z073_WAIT */
+    int32           waitTout;       /**< Z073_WAIT timeout [ms] (not used
+                                         by Z073_BLK_WAIT) */
+    u_int32         waitCnt;        /**< number of Z073_WAIT callers */
+
+    /* event signals */
+    OSS_SIG_HANDLE  *evtSig[Z73_EVTSIG_MAX]; /**< signal per event type */
+    u_int32         evtSigNoQ;      /**< don't queue signalled events */
 } LL_HANDLE;
 
 /* include files which need LL_HANDLE */
@@ -180,7 +517,75 @@ static int32 Z73_Info(int32 infoType, ... );
 static char* Ident( void );
 static int32 Cleanup(LL_HANDLE *llHdl, int32 retCode);
 
-static int32 getStatus( LL_HANDLE *llHdl );
+static int32 getStatus( LL_HANDLE *llHdl, u_int32 noQueue );
+static int32 buildStatus( LL_HANDLE *llHdl, u_int32 curIrqStat,
+                          u_int32 noQueue );
+static void irqProcess( LL_HANDLE *llHdl, u_int32 irqRaw );
+static void deferProcess( void *arg );
+static u_int32 readPosCnt( LL_HANDLE *llHdl );
+static int32 putStatus( LL_HANDLE *llHdl, Z73_QUEUE *q, u_int32 status );
+static void movePut( LL_HANDLE *llHdl, u_int32 inputs );
+static int32 statusGet( LL_HANDLE *llHdl, Z73_EVENT *ev );
+static int32 qAlloc( LL_HANDLE *llHdl, Z73_QUEUE *q, u_int32 depth );
+static void qFree( LL_HANDLE *llHdl, Z73_QUEUE *q );
+static int32 qResize( LL_HANDLE *llHdl, Z73_QUEUE *q, u_int32 depth );
+static void qMove( LL_HANDLE *llHdl, Z73_QUEUE *q, u_int8 *buf,
+                   u_int32 gotsize, u_int32 size );
+static void qSpareGet( LL_HANDLE *llHdl );
+static void qGrowAlarm( void *arg );
+static u_int32 qPeek( Z73_QUEUE *q, Z73_EVENT *ev );
+static void qDrop( Z73_QUEUE *q, Z73_EVENT *ev, u_int32 len );
+static void cqPut( Z73_QUEUE *q, u_int32 status, u_int32 tick, u_int32 seq );
+static void cqPutByte( Z73_QUEUE *q, u_int8 val );
+static void cqPut32( Z73_QUEUE *q, u_int32 val );
+static u_int32 cqGet32( Z73_QUEUE *q, u_int32 off );
+static void qAdapt( LL_HANDLE *llHdl );
+static void capWrite( LL_HANDLE *llHdl, u_int32 irqRaw );
+static int32 capEnable( LL_HANDLE *llHdl, u_int32 depth );
+static int32 sumEnable( LL_HANDLE *llHdl, u_int32 intv );
+static void sumClose( LL_HANDLE *llHdl, u_int32 now );
+static Z73_SUMMARY *sumGet( LL_HANDLE *llHdl, int32 pos );
+static void sumPos( LL_HANDLE *llHdl, int32 delta, u_int32 ts );
+static void irqArm( LL_HANDLE *llHdl );
+static int32 devReset( LL_HANDLE *llHdl, u_int32 flags, int32 pos );
+static void qFlush( Z73_QUEUE *q );
+static int32 warmRestore( LL_HANDLE *llHdl );
+static void warmSave( LL_HANDLE *llHdl );
+static int32 ckptApply( LL_HANDLE *llHdl, int32 pos, u_int32 inputs );
+static void posExtrap( LL_HANDLE *llHdl, Z73_POS_EXTRAP *px );
+static int32 posHistStale( LL_HANDLE *llHdl );
+#ifdef Z73_TS_CYCLES
+static u_int32 tsCalibrate( LL_HANDLE *llHdl );
+#endif
+static int32 scaleDiv( int32 a, u_int32 b, u_int32 c );
+static u_int32 satAdd( u_int32 a, u_int32 b );
+static void gestureArm( LL_HANDLE *llHdl, u_int32 msec, u_int32 cyclic );
+static void gestureEmit( LL_HANDLE *llHdl, u_int32 code );
+static void gesturePress( LL_HANDLE *llHdl );
+static void gestureRelease( LL_HANDLE *llHdl );
+static void gestureInput( LL_HANDLE *llHdl, u_int32 irqReg );
+static void gestureAlarm( void *arg );
+static void sigNotify( LL_HANDLE *llHdl, u_int32 flags );
+static void sigSendPending( LL_HANDLE *llHdl );
+static void sigRearm( LL_HANDLE *llHdl );
+static void sigLatAlarm( void *arg );
+static int32 waitReady( LL_HANDLE *llHdl, int32 tout, u_int32 *fillP );
+static void wdogSet( LL_HANDLE *llHdl, u_int32 maxMs );
+static void wdogAlarm( void *arg );
+static void evtSigSend( LL_HANDLE *llHdl, u_int32 evt );
+static void evtSigRemove( LL_HANDLE *llHdl );
+#ifdef Z73_TRACE
+static void trcWrite( LL_HANDLE *llHdl, u_int16 id, u_int32 a, u_int32 b );
+#endif
+#ifdef Z73_MMIO_LOG
+static u_int32 mmioRead( LL_HANDLE *llHdl, u_int32 off );
+static void mmioWrite( LL_HANDLE *llHdl, u_int32 off, u_int32 val );
+static void mmioRec( LL_HANDLE *llHdl, u_int16 type, u_int32 a, u_int32 b );
+static void mmioApi( LL_HANDLE *llHdl, u_int16 type, int32 code,
+                     INT32_OR_64 arg );
+#endif
+static void irqCauseEnable( LL_HANDLE *llHdl, u_int32 enBit, u_int32 irqBit,
+                            int32 value );
 
 #ifdef __cplusplus
       }
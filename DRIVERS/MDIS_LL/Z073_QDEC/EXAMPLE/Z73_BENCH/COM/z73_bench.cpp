@@ -0,0 +1,333 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   Z73_BENCH                        ************
+ ************                                                    ************
+ ****************************************************************************/
+/*!
+ *         \file z73_bench.cpp
+ *       \author Christian.Schuster@men.de
+ *
+ *       \brief  Benchmark of the C++ client library MEN/z73.hpp
+ *
+ *               Measures the consumer paths of the library while the
+ *               encoder is turned:
+ *
+ *               - raw:      Device::wait() and batched Device::read()
+ *                           in the calling thread (baseline)
+ *               - queue:    Reader thread, events taken with pop()
+ *               - callback: Reader thread, events counted in the callback
+ *
+ *               The encoder should be turned during each run (-d). The
+ *               program reports events per second, events per wake up, the
+ *               CPU time per event and the losses of each stage: gaps in
+ *               the sequence numbers (movement merged or button entries
+ *               dropped by the driver), Reader::dropped() and
+ *               Device::overruns().
+ *
+ *               With -s only the lock-free queue is measured between two
+ *               threads, no device is needed.
+ *
+ *     Required: C++17, libraries: mdis_api, usr_oss, usr_utl
+ *     \switches Z73_POSCNT_24
+ *
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+ /*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <MEN/usr_utl.h>
+#include <MEN/z73.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+/** UTL_TSTOPT() takes a non-const option string */
+#define OPT(o)  UTL_TSTOPT( const_cast<char*>( o ) )
+
+/*--------------------------------------+
+|   TYPDEFS                             |
++--------------------------------------*/
+/** results of one run */
+struct Result
+{
+    std::uint64_t events = 0;   /**< events received */
+    std::uint64_t wakes = 0;    /**< wake ups with events, 0=unknown */
+    std::uint64_t gaps = 0;     /**< missing sequence numbers */
+    std::uint64_t dropped = 0;  /**< Reader queue full */
+    u_int32 overruns = 0;       /**< driver button queue full */
+    double sec = 0;             /**< wall time */
+    double cpu = 0;             /**< process CPU time [s] */
+};
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static void Count( Result &r, const z73::Event &ev, u_int32 &nextSeq );
+static void Print( const char *mode, const Result &r );
+static Result BenchRaw( z73::Device &dev, double sec );
+static Result BenchQueue( z73::Device &dev, double sec, std::size_t cap );
+static Result BenchCallback( z73::Device &dev, double sec );
+static void BenchSpsc( std::uint64_t num, std::size_t cap );
+
+/********************************* main ************************************/
+/** Program main function
+ *
+ *  \param argc       \IN  argument counter
+ *  \param argv       \IN  argument vector
+ *
+ *  \return           success (0) or error (1)
+ */
+int main( int argc, char *argv[] )
+{
+    char *str;
+    double sec;
+    std::size_t cap;
+
+    if( argc < 2 || std::strcmp( argv[1], "-?" ) == 0 ) {
+        std::printf( "Syntax: z73_bench <device> [opts]\n" );
+        std::printf( "        z73_bench -s [opts]\n" );
+        std::printf( "Function: benchmark of the Z73 C++ client library\n" );
+        std::printf( "Options:\n" );
+        std::printf( "    device       device name\n" );
+        std::printf( "    [-m=<mode>]  r=raw q=queue c=callback a=all  [a]\n" );
+        std::printf( "    [-d=<sec>]   duration per mode                [5]\n" );
+        std::printf( "    [-q=<n>]     Reader queue capacity            [1024]\n" );
+        std::printf( "    [-s]         lock-free queue only, no device\n" );
+        std::printf( "    [-n=<n>]     events passed with -s            [10000000]\n" );
+        std::printf( "\n" );
+        return 1;
+    }
+
+    sec = (str = OPT( "d=" )) ? std::atof( str ) : 5.0;
+    cap = (str = OPT( "q=" )) ? std::strtoul( str, nullptr, 0 ) : 1024;
+
+    if( OPT( "s" ) ) {
+        BenchSpsc( (str = OPT( "n=" )) ?
+                   std::strtoull( str, nullptr, 0 ) : 10000000, cap );
+        return 0;
+    }
+
+    try {
+        const char mode = (str = OPT( "m=" )) ? *str : 'a';
+        z73::Device dev( argv[1] );
+
+        dev.setstat( Z073_INT_UP, 1 );
+        dev.setstat( Z073_INT_DWN, 1 );
+        dev.setstat( Z073_INT_PRS, 1 );
+        dev.setstat( Z073_INT_REL, 1 );
+        dev.enable( true );
+
+        std::printf( "%-9s %10s %9s %8s %9s %8s %8s %8s\n", "mode",
+                     "events", "ev/s", "ev/wake", "us/ev", "gaps",
+                     "dropped", "overrun" );
+
+        if( mode == 'r' || mode == 'a' )
+            Print( "raw", BenchRaw( dev, sec ) );
+        if( mode == 'q' || mode == 'a' )
+            Print( "queue", BenchQueue( dev, sec, cap ) );
+        if( mode == 'c' || mode == 'a' )
+            Print( "callback", BenchCallback( dev, sec ) );
+
+        dev.enable( false );
+    }
+    catch( const z73::Error &e ) {
+        std::printf( "*** %s\n", e.what() );
+        return 1;
+    }
+    return 0;
+}
+
+/********************************* Count ***********************************/
+/** Count an event and the sequence numbers missing before it
+ *
+ *  \param r          \IN  results
+ *  \param ev         \IN  event
+ *  \param nextSeq    \IN  expected sequence number, 0 = first event
+ *                    \OUT next expected sequence number
+ */
+static void Count( Result &r, const z73::Event &ev, u_int32 &nextSeq )
+{
+    if( r.events && (int32)(ev.seq - nextSeq) > 0 )
+        r.gaps += ev.seq - nextSeq;
+    nextSeq = ev.seq + 1;
+    r.events++;
+}
+
+/********************************* Print ***********************************/
+/** Print the results of one run
+ *
+ *  \param mode       \IN  mode name
+ *  \param r          \IN  results
+ */
+static void Print( const char *mode, const Result &r )
+{
+    std::printf( "%-9s %10llu %9.0f %8.1f %9.2f %8llu %8llu %8u\n", mode,
+                 (unsigned long long)r.events,
+                 r.sec > 0 ? r.events / r.sec : 0.0,
+                 r.wakes ? (double)r.events / r.wakes : 0.0,
+                 r.events ? r.cpu * 1e6 / r.events : 0.0,
+                 (unsigned long long)r.gaps,
+                 (unsigned long long)r.dropped, r.overruns );
+}
+
+/******************************** BenchRaw *********************************/
+/** Wait and read in the calling thread
+ *
+ *  \param dev        \IN  device
+ *  \param sec        \IN  duration [s]
+ *
+ *  \return           results
+ */
+static Result BenchRaw( z73::Device &dev, double sec )
+{
+    Result r;
+    z73::Event ev[64];
+    std::size_t n, i;
+    u_int32 nextSeq = 0, ovr = dev.overruns();
+    const auto end = Clock::now() + std::chrono::duration<double>( sec );
+    const auto t0 = Clock::now();
+    const std::clock_t c0 = std::clock();
+
+    while( Clock::now() < end ) {
+        if( !dev.wait( 100 ) )
+            continue;
+        if( (n = dev.read( ev )) > 0 )
+            r.wakes++;
+        for( i = 0; i < n; i++ )
+            Count( r, ev[i], nextSeq );
+    }
+
+    r.sec = std::chrono::duration<double>( Clock::now() - t0 ).count();
+    r.cpu = (double)(std::clock() - c0) / CLOCKS_PER_SEC;
+    r.overruns = dev.overruns() - ovr;
+    return r;
+}
+
+/******************************* BenchQueue ********************************/
+/** Reader thread in queue mode, events taken with pop()
+ *
+ *  \param dev        \IN  device
+ *  \param sec        \IN  duration [s]
+ *  \param cap        \IN  queue capacity
+ *
+ *  \return           results
+ */
+static Result BenchQueue( z73::Device &dev, double sec, std::size_t cap )
+{
+    Result r;
+    z73::Event ev;
+    u_int32 nextSeq = 0, ovr = dev.overruns();
+    const auto end = Clock::now() + std::chrono::duration<double>( sec );
+    const auto t0 = Clock::now();
+    const std::clock_t c0 = std::clock();
+    z73::Reader rd( dev, cap );
+
+    while( Clock::now() < end && rd.running() ) {
+        if( !rd.pop( ev, std::chrono::milliseconds( 100 ) ) )
+            continue;
+        r.wakes++;
+        do {
+            Count( r, ev, nextSeq );
+        } while( rd.tryPop( ev ) );
+    }
+    rd.stop();
+
+    r.sec = std::chrono::duration<double>( Clock::now() - t0 ).count();
+    r.cpu = (double)(std::clock() - c0) / CLOCKS_PER_SEC;
+    r.dropped  = rd.dropped();
+    r.overruns = dev.overruns() - ovr;
+    if( rd.exception() )
+        std::rethrow_exception( rd.exception() );
+    return r;
+}
+
+/****************************** BenchCallback ******************************/
+/** Reader thread in callback mode
+ *
+ *  \param dev        \IN  device
+ *  \param sec        \IN  duration [s]
+ *
+ *  \return           results
+ */
+static Result BenchCallback( z73::Device &dev, double sec )
+{
+    Result r;
+    u_int32 nextSeq = 0, ovr = dev.overruns();
+    const auto t0 = Clock::now();
+    const std::clock_t c0 = std::clock();
+    z73::Reader rd( dev, [&]( const z73::Event &ev ) {
+        Count( r, ev, nextSeq ); } );
+
+    std::this_thread::sleep_for( std::chrono::duration<double>( sec ) );
+    rd.stop();
+
+    r.sec = std::chrono::duration<double>( Clock::now() - t0 ).count();
+    r.cpu = (double)(std::clock() - c0) / CLOCKS_PER_SEC;
+    r.overruns = dev.overruns() - ovr;
+    if( rd.exception() )
+        std::rethrow_exception( rd.exception() );
+    return r;
+}
+
+/******************************** BenchSpsc ********************************/
+/** Pass events through the lock-free queue between two threads
+ *
+ *  \param num        \IN  events to pass
+ *  \param cap        \IN  queue capacity
+ */
+static void BenchSpsc( std::uint64_t num, std::size_t cap )
+{
+    z73::SpscQueue<z73::Event> q( cap );
+    std::uint64_t full = 0, bad = 0;
+    z73::Event ev;
+    const auto t0 = Clock::now();
+
+    std::thread prod( [&] {
+        z73::Event e;
+
+        for( std::uint64_t i = 0; i < num; i++ ) {
+            e.seq = (u_int32)i;
+            while( !q.push( e ) ) {
+                full++;
+                std::this_thread::yield();
+            }
+        }
+    } );
+
+    for( std::uint64_t i = 0; i < num; i++ ) {
+        while( !q.pop( ev ) )
+            std::this_thread::yield();
+        if( ev.seq != (u_int32)i )
+            bad++;
+    }
+    prod.join();
+
+    const double sec =
+        std::chrono::duration<double>( Clock::now() - t0 ).count();
+
+    std::printf( "SpscQueue capacity %zu: %llu events in %.3f s, "
+                 "%.1f ns/event, %llu times full, %llu out of order\n",
+                 q.capacity(), (unsigned long long)num, sec,
+                 num ? sec * 1e9 / num : 0.0, (unsigned long long)full,
+                 (unsigned long long)bad );
+}
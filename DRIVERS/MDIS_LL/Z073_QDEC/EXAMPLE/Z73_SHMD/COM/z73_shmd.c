@@ -0,0 +1,389 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   Z73_SHMD                         ************
+ ************                                                    ************
+ ****************************************************************************/
+/*!
+ *         \file z73_shmd.c
+ *       \author Christian.Schuster@men.de
+ *
+ *       \brief  Daemon publishing Z73 state and events in shared memory
+ *
+ *               Owns the paths of one or more Z73 devices, so several local
+ *               processes can follow them without competing for the status
+ *               queue. The daemon waits on all paths with a Z73 wait set,
+ *               drains the events in batches (Z073_BLK_EVENTS) and writes
+ *               them to one slot per device of a POSIX shared memory
+ *               segment (layout see z73_shm.h). Each slot holds the current
+ *               state and a ring of the newest events and is protected by a
+ *               seqlock, readers never block the daemon. The state (position,
+ *               heartbeat) is refreshed every poll cycle.
+ *
+ *               Readers use Z73_ShmOpen(), Z73_ShmState() and
+ *               Z73_ShmEvents() of the z73_api library.
+ *
+ *     Required: libraries: mdis_api, usr_oss, usr_utl, z73_api
+ *     \switches LINUX (required, other systems print an error)
+ *
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+ /*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#ifdef LINUX
+# include <errno.h>
+# include <signal.h>
+# include <unistd.h>
+# include <fcntl.h>
+# include <sys/mman.h>
+#endif
+#include <MEN/men_typs.h>
+#include <MEN/usr_oss.h>
+#include <MEN/usr_utl.h>
+#include <MEN/mdis_api.h>
+#include <MEN/mdis_err.h>
+#include <MEN/z73_drv.h>
+#include <MEN/z73_shm.h>
+#include <MEN/z73_api.h>
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define EV_BATCH	64		/**< events read per getstat */
+
+#ifdef LINUX
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+static volatile sig_atomic_t G_endMe;	/**< SIGINT/SIGTERM received */
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static void PrintError(char *info);
+static void SigHandler(int sig);
+static void SlotBegin(Z73_SHM_SLOT *slot);
+static void SlotEnd(Z73_SHM_SLOT *slot);
+static int32 DrainDevice(MDIS_PATH path, Z73_SHM_SLOT *slot);
+static void UpdateState(MDIS_PATH path, Z73_SHM_SLOT *slot);
+
+/********************************* main ************************************/
+/** Program main function
+ *
+ *  \param argc       \IN  argument counter
+ *  \param argv       \IN  argument vector
+ *
+ *  \return           success (0) or error (1)
+ */
+int main( int argc, char *argv[] )
+{
+	char		*name, *str;
+	MDIS_PATH	path[Z73_SHM_DEV_MAX];
+	char		*device[Z73_SHM_DEV_MAX];
+	u_int8		ready[Z73_SHM_DEV_MAX];
+	int32		sig[Z73_SHM_DEV_MAX];
+	Z73_WAITSET	*ws = NULL;
+	Z73_SHM		*shm = NULL;
+	u_int32		num = 0, i, looptime, keep;
+	int32		n, error;
+	int			fd, ret = 0;
+	struct sigaction sa;
+
+	if (argc < 2 || strcmp(argv[1],"-?")==0) {
+		printf("Syntax: z73_shmd <device> [<device>..] [opts]\n");
+		printf("Function: publish Z73 state and events in shared memory\n");
+		printf("Options:\n");
+		printf("    device       device name(s), max. %d\n", Z73_SHM_DEV_MAX);
+		printf("    [-n=<name>]  shared memory name            [%s]\n",
+			   Z73_SHM_NAME_DEF);
+		printf("    [-t=<ms>]    state update period           [100]\n");
+		printf("    [-s=<sig>]   ready signal of first device,\n");
+		printf("                 next devices use the following [SIGRTMIN]\n");
+		printf("    [-k]         keep segment on exit\n");
+		printf("\n");
+		return(1);
+	}
+
+	name     = ((str = UTL_TSTOPT("n=")) ? str : Z73_SHM_NAME_DEF);
+	looptime = ((str = UTL_TSTOPT("t=")) ? atoi(str) : 100);
+	keep     = UTL_TSTOPT("k") ? 1 : 0;
+	sig[0]   = ((str = UTL_TSTOPT("s=")) ? atoi(str) : SIGRTMIN);
+
+	for (i=1; i<(u_int32)argc; i++) {
+		if (*argv[i] == '-')
+			continue;
+		if (num == Z73_SHM_DEV_MAX) {
+			printf("*** max. %d devices\n", Z73_SHM_DEV_MAX);
+			return(1);
+		}
+		if (strlen(argv[i]) >= Z73_SHM_NAMELEN) {
+			printf("*** device name too long: %s\n", argv[i]);
+			return(1);
+		}
+		device[num++] = argv[i];
+	}
+	if (num == 0) {
+		printf("*** no device given\n");
+		return(1);
+	}
+	if (sig[0] <= 0 || sig[0] + (int32)num - 1 > SIGRTMAX) {
+		printf("*** signals %d..%d not available\n", sig[0],
+			   sig[0] + (int32)num - 1);
+		return(1);
+	}
+	for (i=1; i<num; i++)
+		sig[i] = sig[0] + i;
+
+	/*--------------------+
+	|  shared memory      |
+	+--------------------*/
+	if ((fd = shm_open(name, O_CREAT | O_RDWR, 0644)) < 0) {
+		perror(name);
+		return(1);
+	}
+	if (ftruncate(fd, sizeof(Z73_SHM)) < 0 ||
+		(shm = (Z73_SHM*)mmap(NULL, sizeof(Z73_SHM), PROT_READ | PROT_WRITE,
+							  MAP_SHARED, fd, 0)) == MAP_FAILED) {
+		perror(name);
+		close(fd);
+		shm_unlink(name);
+		return(1);
+	}
+	close(fd);
+
+	/* readers ignore the segment until the magic is set */
+	shm->magic = 0;
+	Z73_SHM_WMB();
+	memset(shm, 0, sizeof(Z73_SHM));
+	shm->version  = Z73_SHM_VERSION;
+	shm->numDev   = num;
+	shm->ringSize = Z73_SHM_RING;
+	shm->pid      = (u_int32)getpid();
+
+	/*--------------------+
+	|  devices            |
+	+--------------------*/
+	for (i=0; i<num; i++) {
+		strcpy(shm->slot[i].device, device[i]);
+
+		if ((path[i] = M_open(device[i])) < 0) {
+			PrintError("open");
+			ret = 1;
+			goto CLEANUP;
+		}
+
+		if (M_setstat(path[i], Z073_INT_PRS, 1) < 0 ||
+			M_setstat(path[i], Z073_INT_REL, 1) < 0 ||
+			M_setstat(path[i], Z073_INT_UP, 1) < 0 ||
+			M_setstat(path[i], Z073_INT_DWN, 1) < 0 ||
+			M_setstat(path[i], M_MK_CH_CURRENT, Z073_CH_POS) < 0 ||
+			M_setstat(path[i], M_MK_IRQ_ENABLE, 1) < 0) {
+			PrintError("setup device");
+			M_close(path[i]);
+			ret = 1;
+			goto CLEANUP;
+		}
+		UpdateState(path[i], &shm->slot[i]);
+	}
+
+	if ((error = Z73_WaitSetCreate(path, sig, num, &ws))) {
+		printf("*** can't create wait set: %s\n", M_errstring(error));
+		ret = 1;
+		goto CLEANUP;
+	}
+
+	Z73_SHM_WMB();
+	shm->magic = Z73_SHM_MAGIC;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = SigHandler;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+
+	printf("publishing %u device(s) in %s\n", (unsigned)num, name);
+
+	/*--------------------+
+	|  main loop          |
+	+--------------------*/
+	while (!G_endMe) {
+		n = Z73_WaitSetWait(ws, looptime, ready);
+		if (n < 0) {
+			if (UOS_ErrnoGet() == ERR_OS + EINTR)
+				continue;
+			PrintError("wait");
+			ret = 1;
+			break;
+		}
+
+		for (i=0; i<num; i++) {
+			if (ready[i] && !shm->slot[i].state.error)
+				DrainDevice(path[i], &shm->slot[i]);
+			UpdateState(path[i], &shm->slot[i]);
+		}
+	}
+
+CLEANUP:
+	if (ws)
+		Z73_WaitSetDestroy(&ws);
+
+	/* paths opened so far */
+	while (i-- > 0) {
+		M_setstat(path[i], M_MK_IRQ_ENABLE, 0);
+		M_close(path[i]);
+	}
+
+	shm->magic = 0;
+	munmap((void*)shm, sizeof(Z73_SHM));
+	if (!keep)
+		shm_unlink(name);
+
+	return(ret);
+}
+
+/******************************** DrainDevice ******************************/
+/** Read all queued events of a device and publish them
+ *
+ *  Errors stop the device (Z73_SHM_STATE.error).
+ *
+ *  \param path       \IN  device path
+ *  \param slot       \IN  slot of the device
+ *
+ *  \return           number of events published
+ */
+static int32 DrainDevice( MDIS_PATH path, Z73_SHM_SLOT *slot )
+{
+	Z73_EVENT	ev[EV_BATCH];
+	M_SG_BLOCK	blk;
+	u_int32		n, i, total = 0;
+	int32		error;
+
+	for (;;) {
+		blk.size = sizeof(ev);
+		blk.data = (void*)ev;
+
+		if (M_getstat(path, Z073_BLK_EVENTS, (int32*)&blk) < 0) {
+			error = (int32)UOS_ErrnoGet();
+			if (error == Z073_ERR_NO_STATUS)
+				break;
+
+			SlotBegin(slot);
+			slot->state.error = error;
+			SlotEnd(slot);
+
+			PrintError("read events");
+			break;
+		}
+
+		n = (u_int32)blk.size / sizeof(Z73_EVENT);
+
+		SlotBegin(slot);
+		for (i=0; i<n; i++)
+			slot->ring[slot->state.events++ % Z73_SHM_RING] = ev[i];
+		if (n) {
+			slot->state.status = ev[n-1].status;
+			slot->state.tick   = ev[n-1].tick;
+			slot->state.seq    = ev[n-1].seq;
+		}
+		SlotEnd(slot);
+
+		total += n;
+		if (n < EV_BATCH)
+			break;
+	}
+
+	return((int32)total);
+}
+
+/******************************** UpdateState ******************************/
+/** Refresh position, dropped entries and heartbeat of a device
+ *
+ *  \param path       \IN  device path
+ *  \param slot       \IN  slot of the device
+ */
+static void UpdateState( MDIS_PATH path, Z73_SHM_SLOT *slot )
+{
+	int32 pos, dropped;
+
+	if (slot->state.error || M_read(path, &pos) < 0)
+		pos = slot->state.pos;
+	if (slot->state.error || M_getstat(path, Z073_BTNQ_DROPPED, &dropped) < 0)
+		dropped = (int32)slot->state.overruns;
+
+	SlotBegin(slot);
+	slot->state.pos      = pos;
+	slot->state.overruns = (u_int32)dropped;
+	slot->state.alive = UOS_MsecTimerGet();
+	SlotEnd(slot);
+}
+
+/********************************* SlotBegin *******************************/
+/** Start writing a slot, the seqlock becomes odd
+ *
+ *  \param slot       \IN  slot
+ */
+static void SlotBegin( Z73_SHM_SLOT *slot )
+{
+	slot->lock++;
+	Z73_SHM_WMB();
+}
+
+/********************************** SlotEnd ********************************/
+/** Finish writing a slot, the seqlock becomes even
+ *
+ *  \param slot       \IN  slot
+ */
+static void SlotEnd( Z73_SHM_SLOT *slot )
+{
+	Z73_SHM_WMB();
+	slot->lock++;
+}
+
+/********************************* SigHandler ******************************/
+/** Terminate the main loop
+ *
+ *  \param sig        \IN  signal number
+ */
+static void SigHandler( int sig )
+{
+	(void)sig;
+	G_endMe = 1;
+}
+
+/********************************* PrintError ******************************/
+/** Print MDIS error message
+ *
+ *  \param info       \IN  info string
+ */
+static void PrintError(char *info)
+{
+	printf("*** can't %s: %s\n", info, M_errstring(UOS_ErrnoGet()));
+}
+
+#else /* LINUX */
+
+int main( int argc, char *argv[] )
+{
+	(void)argc;
+	(void)argv;
+	printf("*** z73_shmd requires POSIX shared memory (LINUX)\n");
+	return(1);
+}
+
+#endif /* LINUX */
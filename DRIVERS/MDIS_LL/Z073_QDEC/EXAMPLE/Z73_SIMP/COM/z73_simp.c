@@ -96,7 +96,8 @@ int main( int argc, char *argv[] )
 	u_int32 mode = 0;	/* Basic tool mode
 						 * 0: interrupt/signal based
 						 * 1: polling mode */
-	u_int32 flag_QFull = 0;
+	u_int32 sigMode = 0;
+	int32 dropped = 0, droppedOld = 0;
 
 	if (argc < 2 || strcmp(argv[1],"-?")==0) {
 		printf("Syntax: z73_simp <device> [opts]\n");
@@ -105,6 +106,7 @@ int main( int argc, char *argv[] )
 		printf("    device       device name\n");
 		printf("    [-t]         loop time in milliseconds [1000]\n");
 		printf("    [-p]         perform test in polling mode\n");
+		printf("    [-m=<mode>]  signal mode: 0=every event, 1=edge     [0]\n");
 		printf("\n");
 		return(1);
 	}
@@ -113,6 +115,7 @@ int main( int argc, char *argv[] )
 
 	looptime = ((str = UTL_TSTOPT("t=")) ? atoi(str) : 1000);
 	mode = UTL_TSTOPT("p") ? 1 : 0;
+	sigMode = ((str = UTL_TSTOPT("m=")) ? atoi(str) : Z073_SIGMODE_EVERY);
 
 	/*--------------------+
 	|  open path          |
@@ -135,6 +138,12 @@ int main( int argc, char *argv[] )
 			goto ERR_EXIT_SIG_HDL;
 		}
 
+		if( M_setstat(G_Z73_path, Z073_SIG_MODE, sigMode) )
+		{
+			PrintError("M_setstat Z073_SIG_MODE");
+			error = 1;
+			goto ERR_EXIT_SIGS;
+		}
 		if( M_setstat(G_Z73_path, Z073_SIG_PRS_REL, UOS_SIG_USR1) )
 		{
 			PrintError("M_setstat signal Z073_SIG_PRS_REL");
@@ -175,18 +184,23 @@ int main( int argc, char *argv[] )
 				/* get all status messages */
 				do {
 					error = getStatus();
-					if( error && (error == Z073_ERR_STATUSQ_FULL) ) {
-						/* queue overflow, interrupts have to be enabled again */
-						flag_QFull = 1;
-					}
-				} while( error != Z073_ERR_NO_STATUS );
+				} while( !error );
 
-				if( flag_QFull && (M_setstat(G_Z73_path, M_MK_IRQ_ENABLE, 1) < 0) )
+				if( error != Z073_ERR_NO_STATUS )
+					G_Z73_endMe = TRUE;
+
+				/* button queue overflow, the driver drops and counts */
+				if( M_getstat(G_Z73_path, Z073_BTNQ_DROPPED, &dropped) )
 				{
-					PrintError("setstat M_MK_IRQ_ENABLE");
+					PrintError("getstat Z073_BTNQ_DROPPED");
 					G_Z73_endMe = TRUE;
 				}
-				flag_QFull = 0; /* queue emptied? reset flag */
+				else if( dropped != droppedOld )
+				{
+					printf( "*** button queue full, %d entries dropped\n",
+							(int)(dropped - droppedOld) );
+					droppedOld = dropped;
+				}
 
 				/* everything read, reset counters */
 				G_Z73_sigUosCnt[0] = 0;
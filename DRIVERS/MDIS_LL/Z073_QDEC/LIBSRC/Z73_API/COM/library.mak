@@ -0,0 +1,40 @@
+#***************************  M a k e f i l e  *******************************
+#
+#         Author: agent
+#
+#    Description: Makefile definitions for the Z73 user library
+#
+#-----------------------------------------------------------------------------
+#   Copyright 2026, MEN Mikro Elektronik GmbH
+#*****************************************************************************
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+MAK_NAME=z73_api
+# the next line is updated during the MDIS installation
+STAMPED_REVISION="13Z073-06_01_06-0-g65ee227-dirty_2016-05-03"
+
+DEF_REVISION=MAK_REVISION=$(STAMPED_REVISION)
+MAK_SWITCH=$(SW_PREFIX)$(DEF_REVISION)
+
+MAK_INCL=$(MEN_INC_DIR)/z73_api.h	\
+         $(MEN_INC_DIR)/z73_shm.h	\
+         $(MEN_INC_DIR)/z73_drv.h	\
+         $(MEN_INC_DIR)/men_typs.h	\
+         $(MEN_INC_DIR)/mdis_api.h	\
+         $(MEN_INC_DIR)/mdis_err.h	\
+         $(MEN_INC_DIR)/usr_oss.h	\
+
+MAK_INP1=z73_api$(INP_SUFFIX)
+
+MAK_INP=$(MAK_INP1)
@@ -0,0 +1,611 @@
+/*********************  P r o g r a m  -  M o d u l e ***********************/
+/*!
+ *        \file  z73_api.c
+ *
+ *      \author  Christian.Schuster@men.de
+ *
+ *      \brief   User library for the Z73 driver
+ *
+ *               Waits on several Z73 paths with one call. Each path gets
+ *               its own Z073_SIG_READY signal, chosen by the caller, which
+ *               is edge triggered and re-armed by the driver when the
+ *               status queue was read empty. The application therefore has
+ *               to read all status entries (until Z073_ERR_NO_STATUS) of a
+ *               path reported ready.
+ *
+ *               On Linux the signals are received through a signalfd. The
+ *               descriptor returned by Z73_WaitSetFd() can be added to the
+ *               application's own poll()/select()/epoll loop. The signals
+ *               are blocked in the calling thread, so the wait set should
+ *               be created before other threads are started. On other
+ *               systems the signals are installed with UOS_SigInstall()
+ *               (the application must have called UOS_SigInit()) and
+ *               Z73_WaitSetWait() blocks in UOS_SigWait(). A wait set with
+ *               a single path blocks in the driver (Z073_BLK_WAIT) and
+ *               needs no signal there.
+ *
+ *               The wait set never changes device settings shared with
+ *               other paths, the timeout is passed with each Z073_BLK_WAIT.
+ *
+ *               Z73_ShmOpen()/Z73_ShmState()/Z73_ShmEvents() read the
+ *               shared memory segment published by the daemon z73_shmd
+ *               (see z73_shm.h, Linux only). After Z73_ShmOpen() no
+ *               system call is made and the daemon is never blocked. Only
+ *               when a slot stays locked, the reader yields and checks
+ *               that the daemon still exists; after Z73_SHM_SPIN +
+ *               Z73_SHM_YIELD tries it gives up with ERR_LL_DEV_NOTRDY.
+ *
+ *     Required: libraries: mdis_api, usr_oss
+ *     \switches LINUX
+ *
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+ /*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#ifdef LINUX
+# include <errno.h>
+# include <signal.h>
+# include <poll.h>
+# include <unistd.h>
+# include <sys/signalfd.h>
+# include <sched.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+#endif
+#include <MEN/men_typs.h>
+#include <MEN/usr_oss.h>
+#include <MEN/mdis_api.h>
+#include <MEN/mdis_err.h>
+#include <MEN/z73_drv.h>
+#include <MEN/z73_shm.h>
+#include <MEN/z73_api.h>
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define Z73_SHM_SPIN	1000		/**< reads of a locked slot before
+										 the reader yields */
+#define Z73_SHM_YIELD	100000		/**< yields before the reader gives up */
+
+/*--------------------------------------+
+|   TYPDEFS                             |
++--------------------------------------*/
+/** wait set */
+struct Z73_WAITSET {
+	u_int32		num;						/**< number of paths */
+	MDIS_PATH	path[Z73_WAITSET_MAX];		/**< paths */
+	int32		sig[Z73_WAITSET_MAX];		/**< ready signal of each path */
+	u_int32		pending;					/**< paths to report w/o signal */
+#ifdef LINUX
+	int			fd;							/**< signalfd */
+	sigset_t	sigMask;					/**< signals used */
+	sigset_t	oldMask;					/**< signal mask before create */
+#endif
+};
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static void RestorePaths( Z73_WAITSET *ws, u_int32 num );
+static int32 SlotBusy( const Z73_SHM *shm, u_int32 *triesP );
+#ifndef LINUX
+static int32 PathReady( MDIS_PATH path, int32 msec );
+#endif
+
+/***************************** Z73_WaitSetCreate ***************************/
+/** Create a wait set for several Z73 paths
+ *
+ *  All paths are reported ready by the first Z73_WaitSetWait(), since
+ *  entries may have been queued before the wait set existed.
+ *
+ *  The signals must not be used otherwise by the application. On Linux
+ *  realtime signals (SIGRTMIN..SIGRTMAX) are recommended, since they are
+ *  queued.
+ *
+ *  \param paths      \IN  paths to wait on
+ *  \param sigs       \IN  ready signal for each path, all different. May be
+ *                         NULL on systems other than Linux for one path.
+ *  \param num        \IN  number of paths (1..Z73_WAITSET_MAX)
+ *  \param wsP        \OUT created wait set
+ *
+ *  \return           \c 0 on success or error code
+ */
+int32 Z73_WaitSetCreate( const MDIS_PATH *paths, const int32 *sigs,
+						 u_int32 num, Z73_WAITSET **wsP )
+{
+	Z73_WAITSET *ws;
+	u_int32 i, j;
+	int32 error = 0;
+
+	*wsP = NULL;
+
+	if( num < 1 || num > Z73_WAITSET_MAX )
+		return( ERR_LL_ILL_PARAM );
+#ifdef LINUX
+	if( sigs == NULL )
+#else
+	if( sigs == NULL && num > 1 )
+#endif
+		return( ERR_LL_ILL_PARAM );
+
+	for( i=0; sigs && i<num; i++ ) {
+		if( sigs[i] <= 0 )
+			return( ERR_LL_ILL_PARAM );
+		for( j=0; j<i; j++ )
+			if( sigs[j] == sigs[i] )
+				return( ERR_LL_ILL_PARAM );
+	}
+
+	if( (ws = (Z73_WAITSET*)calloc( 1, sizeof(*ws) )) == NULL )
+		return( ERR_OSS_MEM_ALLOC );
+
+	ws->num = num;
+	memcpy( ws->path, paths, num * sizeof(MDIS_PATH) );
+	if( sigs )
+		memcpy( ws->sig, sigs, num * sizeof(int32) );
+	ws->pending = (num == 32) ? 0xffffffff : ((1U << num) - 1);
+
+#ifdef LINUX
+	/* one signal per path, received through a signalfd */
+	sigemptyset( &ws->sigMask );
+	for( i=0; i<num; i++ ) {
+		if( sigaddset( &ws->sigMask, ws->sig[i] ) < 0 ) {
+			free( ws );
+			return( ERR_LL_ILL_PARAM );
+		}
+	}
+
+	sigprocmask( SIG_BLOCK, &ws->sigMask, &ws->oldMask );
+
+	if( (ws->fd = signalfd( -1, &ws->sigMask,
+							SFD_NONBLOCK | SFD_CLOEXEC )) < 0 ) {
+		error = ERR_OS + errno;
+		sigprocmask( SIG_SETMASK, &ws->oldMask, NULL );
+		free( ws );
+		return( error );
+	}
+
+	for( i=0; i<num; i++ ) {
+		if( M_setstat( ws->path[i], Z073_SIG_READY, ws->sig[i] ) < 0 ) {
+			error = UOS_ErrnoGet();
+			RestorePaths( ws, i );
+			close( ws->fd );
+			sigprocmask( SIG_SETMASK, &ws->oldMask, NULL );
+			free( ws );
+			return( error );
+		}
+	}
+#else
+	/* one path blocks in the driver, else one UOS signal per path */
+	for( i=0; i<num && num > 1; i++ ) {
+		if( (error = UOS_SigInstall( ws->sig[i] )) == 0 &&
+			M_setstat( ws->path[i], Z073_SIG_READY, ws->sig[i] ) < 0 ) {
+			error = UOS_ErrnoGet();
+			UOS_SigRemove( ws->sig[i] );	/* installed above */
+		}
+		if( error ) {
+			RestorePaths( ws, i );
+			free( ws );
+			return( error );
+		}
+	}
+#endif
+
+	*wsP = ws;
+	return( 0 );
+}
+
+/******************************* Z73_WaitSetFd *****************************/
+/** Get a file descriptor for the application's event loop
+ *
+ *  The descriptor becomes readable when at least one path is ready, call
+ *  Z73_WaitSetWait() with \a msec = 0 then.
+ *
+ *  \param ws         \IN  wait set
+ *
+ *  \return           file descriptor or -1 if not supported
+ */
+int32 Z73_WaitSetFd( Z73_WAITSET *ws )
+{
+#ifdef LINUX
+	return( ws->fd );
+#else
+	return( -1 );
+#endif
+}
+
+/****************************** Z73_WaitSetWait ****************************/
+/** Wait until at least one path of the wait set is ready
+ *
+ *  \param ws         \IN  wait set
+ *  \param msec       \IN  timeout [ms], -1 = forever, 0 = don't block
+ *  \param ready      \OUT ready[i] is set to 1 for each ready path i
+ *
+ *  \return           number of ready paths (0 on timeout) or -1 on error,
+ *                    error code can be retrieved with UOS_ErrnoGet()
+ */
+int32 Z73_WaitSetWait( Z73_WAITSET *ws, int32 msec, u_int8 *ready )
+{
+	u_int32 i;
+	int32 n = 0;
+#ifdef LINUX
+	struct pollfd pfd;
+	struct signalfd_siginfo si;
+	u_int32 j;
+	int rv;
+#else
+	u_int32 sig;
+	int32 rv;
+#endif
+
+	memset( ready, 0, ws->num );
+
+	/* paths already known to be ready */
+	if( ws->pending ) {
+		for( i=0; i<ws->num; i++ ) {
+			if( ws->pending & (1U << i) ) {
+				ready[i] = 1;
+				n++;
+			}
+		}
+		ws->pending = 0;
+		return( n );
+	}
+
+#ifdef LINUX
+	pfd.fd      = ws->fd;
+	pfd.events  = POLLIN;
+	pfd.revents = 0;
+
+	do {
+		rv = poll( &pfd, 1, msec );
+	} while( rv < 0 && errno == EINTR );
+
+	if( rv < 0 ) {
+		UOS_ErrnoSet( ERR_OS + errno );
+		return( -1 );
+	}
+
+	/* collect all queued signals */
+	while( read( ws->fd, &si, sizeof(si) ) == sizeof(si) ) {
+		for( j=0; j<ws->num; j++ ) {
+			if( (int32)si.ssi_signo == ws->sig[j] && !ready[j] ) {
+				ready[j] = 1;
+				n++;
+			}
+		}
+	}
+#else
+	/* single path: block in the driver */
+	if( ws->num == 1 ) {
+		if( (rv = PathReady( ws->path[0], msec )) < 0 )
+			return( -1 );
+		ready[0] = (u_int8)rv;
+		return( rv );
+	}
+
+	/* signals sent before the call are not seen by UOS_SigWait() */
+	for( i=0; i<ws->num; i++ ) {
+		if( (rv = PathReady( ws->path[i], 0 )) < 0 )
+			return( -1 );
+		ready[i] = (u_int8)rv;
+		n += rv;
+	}
+	if( n || msec == 0 )
+		return( n );
+
+	/* UOS_SigWait() waits endless for 0 */
+	if( (rv = UOS_SigWait( msec < 0 ? 0 : (u_int32)msec, &sig )) ) {
+		if( rv == ERR_UOS_TIMEOUT )
+			return( 0 );
+		UOS_ErrnoSet( rv );
+		return( -1 );
+	}
+
+	for( i=0; i<ws->num; i++ ) {
+		if( ws->sig[i] == (int32)sig && !ready[i] ) {
+			ready[i] = 1;
+			n++;
+		}
+	}
+#endif
+
+	return( n );
+}
+
+/***************************** Z73_WaitSetDestroy **************************/
+/** Remove the signals and free the wait set
+ *
+ *  \param wsP        \IN  wait set, \OUT set to NULL
+ *
+ *  \return           \c 0 on success or error code
+ */
+int32 Z73_WaitSetDestroy( Z73_WAITSET **wsP )
+{
+	Z73_WAITSET *ws = *wsP;
+#ifdef LINUX
+	struct signalfd_siginfo si;
+#endif
+
+	if( ws == NULL )
+		return( ERR_LL_ILL_PARAM );
+
+	RestorePaths( ws, ws->num );
+
+#ifdef LINUX
+	/* drain signals still queued, they would kill the process otherwise */
+	while( read( ws->fd, &si, sizeof(si) ) == sizeof(si) )
+		;
+	close( ws->fd );
+	sigprocmask( SIG_SETMASK, &ws->oldMask, NULL );
+#endif
+
+	free( ws );
+	*wsP = NULL;
+	return( 0 );
+}
+
+/******************************* Z73_ShmOpen *******************************/
+/** Map the shared memory segment of z73_shmd read-only
+ *
+ *  \param name       \IN  segment name, NULL for Z73_SHM_NAME_DEF
+ *  \param shmP       \OUT mapped segment
+ *
+ *  \return           \c 0 on success or error code
+ */
+int32 Z73_ShmOpen( const char *name, Z73_SHM **shmP )
+{
+#ifdef LINUX
+	Z73_SHM *shm;
+	struct stat st;
+	int fd, error;
+
+	*shmP = NULL;
+
+	if( (fd = shm_open( name ? name : Z73_SHM_NAME_DEF, O_RDONLY, 0 )) < 0 )
+		return( ERR_OS + errno );
+
+	/* a mapping beyond the end of the object faults on access */
+	if( fstat( fd, &st ) < 0 ) {
+		error = errno;
+		close( fd );
+		return( ERR_OS + error );
+	}
+	if( st.st_size < (off_t)sizeof(Z73_SHM) ) {
+		close( fd );
+		return( ERR_LL_DEV_NOTRDY );	/* daemon still initializing */
+	}
+
+	shm = (Z73_SHM*)mmap( NULL, sizeof(Z73_SHM), PROT_READ, MAP_SHARED,
+						  fd, 0 );
+	error = errno;
+	close( fd );
+	if( shm == MAP_FAILED )
+		return( ERR_OS + error );
+
+	/* daemon still initializing, the magic is written last */
+	if( shm->magic != Z73_SHM_MAGIC ) {
+		munmap( (void*)shm, sizeof(Z73_SHM) );
+		return( ERR_LL_DEV_NOTRDY );
+	}
+	/* header fields not before the magic */
+	Z73_SHM_RMB();
+
+	/* other layout */
+	if( shm->version != Z73_SHM_VERSION || shm->ringSize != Z73_SHM_RING ) {
+		munmap( (void*)shm, sizeof(Z73_SHM) );
+		return( ERR_LL_DEV_NOTRDY );
+	}
+
+	*shmP = shm;
+	return( 0 );
+#else
+	*shmP = NULL;
+	return( ERR_LL_ILL_FUNC );
+#endif
+}
+
+/******************************* Z73_ShmClose ******************************/
+/** Unmap the shared memory segment
+ *
+ *  \param shmP       \IN  segment, \OUT set to NULL
+ *
+ *  \return           \c 0 on success or error code
+ */
+int32 Z73_ShmClose( Z73_SHM **shmP )
+{
+	if( *shmP == NULL )
+		return( ERR_LL_ILL_PARAM );
+#ifdef LINUX
+	munmap( (void*)*shmP, sizeof(Z73_SHM) );
+#endif
+	*shmP = NULL;
+	return( 0 );
+}
+
+/******************************* Z73_ShmState ******************************/
+/** Get a consistent copy of the state of a device
+ *
+ *  \param shm        \IN  segment
+ *  \param dev        \IN  slot number (order of devices given to z73_shmd)
+ *  \param st         \OUT state
+ *
+ *  \return           \c 0 on success or error code,
+ *                    ERR_LL_DEV_NOTRDY if the daemon died or hangs while
+ *                    writing the slot
+ */
+int32 Z73_ShmState( const Z73_SHM *shm, u_int32 dev, Z73_SHM_STATE *st )
+{
+	const Z73_SHM_SLOT *slot;
+	u_int32 lock, tries = 0;
+	int32 error = 0;
+
+	if( dev >= shm->numDev )
+		return( ERR_LL_ILL_PARAM );
+	slot = &shm->slot[dev];
+
+	do {
+		while( (lock = slot->lock) & 1 )
+			if( (error = SlotBusy( shm, &tries )) )
+				return( error );
+		Z73_SHM_RMB();
+		*st = slot->state;
+		Z73_SHM_RMB();
+	} while( slot->lock != lock && !(error = SlotBusy( shm, &tries )) );
+
+	return( error );
+}
+
+/****************************** Z73_ShmEvents ******************************/
+/** Read the events of a device published since the last call
+ *
+ *  The caller keeps the index of the next event in \a nextP. Initialize
+ *  it with Z73_SHM_STATE.events to skip the events published before. When
+ *  the reader falls behind by more than Z73_SHM_RING events, the oldest
+ *  are lost and counted in \a lostP.
+ *
+ *  \param shm        \IN  segment
+ *  \param dev        \IN  slot number
+ *  \param nextP      \IN  index of next event, \OUT updated
+ *  \param ev         \OUT events, oldest first
+ *  \param max        \IN  max. number of events
+ *  \param lostP      \OUT events lost are added, may be NULL
+ *
+ *  \return           number of events or -1 on error (ERR_LL_DEV_NOTRDY
+ *                    if the daemon died or hangs while writing the slot)
+ */
+int32 Z73_ShmEvents( const Z73_SHM *shm, u_int32 dev, u_int32 *nextP,
+					 Z73_EVENT *ev, u_int32 max, u_int32 *lostP )
+{
+	const Z73_SHM_SLOT *slot;
+	u_int32 lock, next, head, lost, n, i, tries = 0;
+	int32 error = 0;
+
+	if( dev >= shm->numDev ) {
+		UOS_ErrnoSet( ERR_LL_ILL_PARAM );
+		return( -1 );
+	}
+	slot = &shm->slot[dev];
+
+	do {
+		while( (lock = slot->lock) & 1 )
+			if( (error = SlotBusy( shm, &tries )) )
+				break;
+		if( error )
+			break;
+		Z73_SHM_RMB();
+
+		next = *nextP;
+		head = slot->state.events;
+		lost = 0;
+		if( head - next > Z73_SHM_RING ) {
+			lost = head - next - Z73_SHM_RING;
+			next = head - Z73_SHM_RING;
+		}
+		n = head - next < max ? head - next : max;
+		for( i=0; i<n; i++ )
+			ev[i] = slot->ring[(next + i) % Z73_SHM_RING];
+
+		Z73_SHM_RMB();
+	} while( slot->lock != lock && !(error = SlotBusy( shm, &tries )) );
+
+	if( error ) {
+		UOS_ErrnoSet( error );
+		return( -1 );
+	}
+	*nextP = next + n;
+	if( lostP )
+		*lostP += lost;
+	return( (int32)n );
+}
+
+/********************************* SlotBusy *******************************/
+/** Count a try of a reader which found a slot locked or changed
+ *
+ *  The daemon writes a slot for microseconds. After Z73_SHM_SPIN tries
+ *  the reader yields and checks that the daemon still exists, after
+ *  Z73_SHM_YIELD more tries it gives up (daemon stopped or hangs).
+ *
+ *  \param shm        \IN  segment
+ *  \param triesP     \IN  tries so far, \OUT incremented
+ *
+ *  \return           \c 0 to try again or ERR_LL_DEV_NOTRDY
+ */
+static int32 SlotBusy( const Z73_SHM *shm, u_int32 *triesP )
+{
+	if( ++*triesP <= Z73_SHM_SPIN )
+		return( 0 );
+	if( *triesP > Z73_SHM_SPIN + Z73_SHM_YIELD )
+		return( ERR_LL_DEV_NOTRDY );
+#ifdef LINUX
+	if( kill( (pid_t)shm->pid, 0 ) < 0 && errno == ESRCH )
+		return( ERR_LL_DEV_NOTRDY );
+	sched_yield();
+#endif
+	return( 0 );
+}
+
+/******************************* RestorePaths *****************************/
+/** Undo the path settings of the first \a num paths
+ *
+ *  \param ws         \IN  wait set
+ *  \param num        \IN  number of paths
+ */
+static void RestorePaths( Z73_WAITSET *ws, u_int32 num )
+{
+	u_int32 i;
+
+	for( i=0; i<num; i++ ) {
+#ifndef LINUX
+		if( ws->num == 1 )
+			break;		/* nothing installed */
+		UOS_SigRemove( ws->sig[i] );
+#endif
+		M_setstat( ws->path[i], Z073_SIG_READY, 0 );
+	}
+}
+
+#ifndef LINUX
+/********************************* PathReady ******************************/
+/** Wait until a path is ready with Z073_BLK_WAIT
+ *
+ *  \param path       \IN  path
+ *  \param msec       \IN  timeout [ms], -1 = forever, 0 = don't block
+ *
+ *  \return           1 = ready, 0 = timeout or -1 on error,
+ *                    error code can be retrieved with UOS_ErrnoGet()
+ */
+static int32 PathReady( MDIS_PATH path, int32 msec )
+{
+	M_SG_BLOCK blk;
+	Z73_WAIT w;
+
+	w.tout   = msec;
+	w.fill   = 0;
+	blk.size = sizeof(w);
+	blk.data = (void*)&w;
+
+	if( M_getstat( path, Z073_BLK_WAIT, (int32*)&blk ) < 0 )
+		return( UOS_ErrnoGet() == ERR_OSS_TIMEOUT ? 0 : -1 );
+
+	return( 1 );
+}
+#endif /* !LINUX */
@@ -0,0 +1,194 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   Z73_CAPTURE                      ************
+ ************                                                    ************
+ ****************************************************************************/
+/*!
+ *         \file z73_capture.c
+ *       \author Christian.Schuster@men.de
+ *
+ *       \brief  Capture the raw encoder edges of a Z73 device
+ *
+ *               Enables the move interrupts and the raw edge capture
+ *               (Z073_CAPTURE), reads the records with Z073_BLK_CAPTURE
+ *               and writes them unchanged to a file, preceded by a
+ *               Z73_TRC_HDR. The file is decoded on the host with
+ *               z73_capdec. Status entries are read and discarded, so
+ *               the status queue can't overflow during the capture.
+ *
+ *     Required: libraries: mdis_api, usr_oss, usr_utl
+ *     \switches (none)
+ *
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+ /*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <MEN/men_typs.h>
+#include <MEN/usr_oss.h>
+#include <MEN/usr_utl.h>
+#include <MEN/mdis_api.h>
+#include <MEN/mdis_err.h>
+#include <MEN/z73_drv.h>
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define REC_CHUNK	256		/**< records read per getstat */
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static void PrintError(char *info);
+
+/********************************* main ************************************/
+/** Program main function
+ *
+ *  \param argc       \IN  argument counter
+ *  \param argv       \IN  argument vector
+ *
+ *  \return           success (0) or error (1)
+ */
+int main( int argc, char *argv[] )
+{
+	char		*device, *file, *str;
+	MDIS_PATH	path;
+	FILE		*fp;
+	Z73_TRC_HDR	hdr;
+	Z73_CAP_REC	rec[REC_CHUNK];
+	M_SG_BLOCK	blk;
+	u_int32		depth, looptime, duration, start, total = 0;
+	int32		n, status, rate;
+	int			ret = 0;
+
+	if (argc < 3 || strcmp(argv[1],"-?")==0) {
+		printf("Syntax: z73_capture <device> <file> [opts]\n");
+		printf("Function: capture Z73 encoder edges to <file>\n");
+		printf("Options:\n");
+		printf("    device       device name\n");
+		printf("    file         output file, decode with z73_capdec\n");
+		printf("    [-n=<recs>]  records in driver capture ring     [1024]\n");
+		printf("    [-d=<sec>]   capture duration, 0=until key      [0]\n");
+		printf("    [-t=<ms>]    poll time                          [50]\n");
+		printf("    [-r=<rate>]  timestamp ticks per second         [driver]  \n");
+		printf("\n");
+		return(1);
+	}
+
+	device = argv[1];
+	file   = argv[2];
+
+	depth    = ((str = UTL_TSTOPT("n=")) ? atoi(str) : 1024);
+	duration = ((str = UTL_TSTOPT("d=")) ? atoi(str) : 0);
+	looptime = ((str = UTL_TSTOPT("t=")) ? atoi(str) : 50);
+
+	hdr.magic    = Z073_CAP_MAGIC;
+	hdr.version  = Z073_CAP_VERSION;
+	hdr.recSize  = sizeof(Z73_CAP_REC);
+
+	if ((path = M_open(device)) < 0) {
+		PrintError("open");
+		return(1);
+	}
+
+	/* timestamp rate of the driver unless given */
+	if ((str = UTL_TSTOPT("r=")))
+		hdr.tickRate = atoi(str);
+	else if (M_getstat(path, Z073_TS_RATE, &rate) < 0)
+		hdr.tickRate = 0;
+	else
+		hdr.tickRate = rate;
+
+	if ((fp = fopen(file, "wb")) == NULL) {
+		perror(file);
+		M_close(path);
+		return(1);
+	}
+
+	if (fwrite(&hdr, sizeof(hdr), 1, fp) != 1) {
+		perror(file);
+		ret = 1;
+		goto EXIT;
+	}
+
+	/* start capture and enable the move interrupts */
+	if (M_setstat(path, Z073_CAPTURE, depth) < 0 ||
+		M_setstat(path, Z073_INT_UP, 1) < 0 ||
+		M_setstat(path, Z073_INT_DWN, 1) < 0 ||
+		M_setstat(path, M_MK_IRQ_ENABLE, 1) < 0) {
+		PrintError("start capture");
+		ret = 1;
+		goto EXIT_CAP;
+	}
+
+	printf("capturing, press any key to stop\n");
+	start = UOS_MsecTimerGet();
+
+	do {
+		UOS_Delay(looptime);
+
+		/* discard status entries */
+		while (M_getstat(path, Z073_STATUS, &status) == 0)
+			;
+
+		/* drain the capture ring */
+		do {
+			blk.size = sizeof(rec);
+			blk.data = (void*)rec;
+			if (M_getstat(path, Z073_BLK_CAPTURE, (int32*)&blk) < 0) {
+				PrintError("getstat Z073_BLK_CAPTURE");
+				ret = 1;
+				goto EXIT_CAP;
+			}
+			n = blk.size / sizeof(Z73_CAP_REC);
+			if (n && fwrite(rec, sizeof(Z73_CAP_REC), n, fp) != (size_t)n) {
+				perror(file);
+				ret = 1;
+				goto EXIT_CAP;
+			}
+			total += n;
+		} while (n == REC_CHUNK);
+
+	} while (UOS_KeyPressed() == -1 &&
+			 (!duration || UOS_MsecTimerGet() - start < duration * 1000));
+
+	printf("%u records written to %s\n", (unsigned)total, file);
+
+EXIT_CAP:
+	M_setstat(path, M_MK_IRQ_ENABLE, 0);
+	M_setstat(path, Z073_CAPTURE, 0);
+
+EXIT:
+	fclose(fp);
+	if (M_close(path) < 0)
+		PrintError("close");
+
+	return(ret);
+}
+
+/********************************* PrintError ******************************/
+/** Print MDIS error message
+ *
+ *  \param info       \IN  info string
+ */
+static void PrintError(char *info)
+{
+	printf("*** can't %s: %s\n", info, M_errstring(UOS_ErrnoGet()));
+}
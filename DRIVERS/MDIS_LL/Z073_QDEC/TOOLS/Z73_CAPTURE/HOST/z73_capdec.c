@@ -0,0 +1,248 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   Z73_CAPDEC                       ************
+ ************                                                    ************
+ ****************************************************************************/
+/*!
+ *         \file z73_capdec.c
+ *       \author Christian.Schuster@men.de
+ *
+ *       \brief  Host decoder for Z73 edge capture files
+ *
+ *               Decodes a file written by z73_capture on the target. From
+ *               the A/B levels of successive records it reconstructs the
+ *               x4 position, counts illegal transitions (both inputs
+ *               changed) and records without level change, and compares
+ *               the result with the counts of the hardware decoder. The
+ *               distribution of the edge rate (interrupts per second) is
+ *               printed as histogram.
+ *
+ *               Plain ANSI C without MDIS headers, build on the host with
+ *               e.g. "cc -o z73_capdec z73_capdec.c". Files written by a
+ *               target of the other byte order are swapped automatically.
+ *
+ *     Required: -
+ *     \switches (none)
+ *
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+ /*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+/* must match z73_drv.h */
+#define CAP_MAGIC		0x5a373343
+#define CAP_VERSION		1
+#define CAP_REC_SIZE	16
+#define CAP_A			0x20
+#define CAP_B			0x10
+#define CAP_PRESS_N		0x40
+
+#define HIST_NUM		7		/**< rate histogram: <1, <10 .. <100k, more */
+
+/*--------------------------------------+
+|   TYPDEFS                             |
++--------------------------------------*/
+typedef unsigned int	u32;
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+static int G_swap;		/**< file has other byte order */
+
+/** quadrature state (A,B) -> phase 0..3 */
+static const int G_phase[4] = { 0, 1, 3, 2 };
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static u32 Get32( const unsigned char *p );
+
+/********************************* main ************************************/
+/** Program main function
+ *
+ *  \param argc       \IN  argument counter
+ *  \param argv       \IN  argument vector
+ *
+ *  \return           success (0) or error (1)
+ */
+int main( int argc, char *argv[] )
+{
+	FILE			*fp;
+	unsigned char	buf[CAP_REC_SIZE];
+	char			*file;
+	u32				tickRate, ts, irq, seq, lastTs = 0, nextSeq = 0, dt;
+	int				delta, verbose = 0, phase, lastPhase = 0, step;
+	long			pos = 0, hwPos = 0;
+	unsigned long	recs = 0, lost = 0, illegal = 0, noChange = 0;
+	unsigned long	hist[HIST_NUM];
+	double			rate, limit;
+	int				i;
+
+	if (argc < 2 || strcmp(argv[1],"-?")==0) {
+		printf("Syntax: z73_capdec [-v] <file>\n");
+		printf("Function: decode Z73 capture file written by z73_capture\n");
+		printf("Options:\n");
+		printf("    -v           print every record\n");
+		return(1);
+	}
+
+	if (argc > 2 && strcmp(argv[1],"-v")==0) {
+		verbose = 1;
+		file = argv[2];
+	}
+	else
+		file = argv[1];
+
+	if ((fp = fopen(file, "rb")) == NULL) {
+		perror(file);
+		return(1);
+	}
+
+	/* header: magic, version, tickRate, recSize */
+	if (fread(buf, 16, 1, fp) != 1) {
+		fprintf(stderr, "*** %s: no header\n", file);
+		fclose(fp);
+		return(1);
+	}
+
+	G_swap = 0;
+	if (Get32(buf) != CAP_MAGIC) {
+		G_swap = 1;
+		if (Get32(buf) != CAP_MAGIC) {
+			fprintf(stderr, "*** %s: not a Z73 capture file\n", file);
+			fclose(fp);
+			return(1);
+		}
+	}
+	if (Get32(buf+4) != CAP_VERSION || Get32(buf+12) != CAP_REC_SIZE) {
+		fprintf(stderr, "*** %s: unsupported version %u / record size %u\n",
+				file, Get32(buf+4), Get32(buf+12));
+		fclose(fp);
+		return(1);
+	}
+	tickRate = Get32(buf+8);
+
+	memset(hist, 0, sizeof(hist));
+
+	if (verbose)
+		printf("%-8s %-10s %-4s %-6s %-8s %-8s\n",
+			   "seq", "dt", "ABP", "delta", "x4 pos", "hw pos");
+
+	while (fread(buf, CAP_REC_SIZE, 1, fp) == 1) {
+		ts    = Get32(buf);
+		irq   = Get32(buf+4);
+		delta = (int)Get32(buf+8);
+		seq   = Get32(buf+12);
+
+		phase = G_phase[((irq & CAP_A) ? 2 : 0) | ((irq & CAP_B) ? 1 : 0)];
+		dt    = ts - lastTs;
+
+		if (recs == 0) {
+			dt = 0;
+		}
+		else {
+			if (seq != nextSeq) {
+				if (verbose)
+					printf("--- %u record(s) lost\n", seq - nextSeq);
+				lost += seq - nextSeq;
+			}
+
+			/* phase step between two interrupts */
+			step = (phase - lastPhase) & 3;
+			if (step == 1)
+				pos++;
+			else if (step == 3)
+				pos--;
+			else if (step == 2)
+				illegal++;
+			else
+				noChange++;
+
+			/* edge rate, same timestamp = faster than resolution */
+			if (tickRate && !dt)
+				hist[HIST_NUM-1]++;
+			else if (tickRate) {
+				rate  = (double)tickRate / dt;
+				limit = 1.0;
+				for (i=0; i<HIST_NUM-1 && rate >= limit; i++)
+					limit *= 10.0;
+				hist[i]++;
+			}
+		}
+		hwPos += delta;
+
+		if (verbose)
+			printf("%-8u %-10u %c%c%c  %-6d %-8ld %-8ld\n",
+				   seq, dt,
+				   (irq & CAP_A) ? '1' : '0',
+				   (irq & CAP_B) ? '1' : '0',
+				   (irq & CAP_PRESS_N) ? '1' : '0',
+				   delta, pos, hwPos);
+
+		lastTs    = ts;
+		lastPhase = phase;
+		nextSeq   = seq + 1;
+		recs++;
+	}
+	fclose(fp);
+
+	printf("records:             %lu\n", recs);
+	printf("records lost:        %lu\n", lost);
+	printf("x4 position (A/B):   %ld\n", pos);
+	printf("hardware counts:     %ld\n", hwPos);
+	printf("illegal transitions: %lu\n", illegal);
+	printf("no level change:     %lu\n", noChange);
+
+	if (tickRate) {
+		printf("edge rate [1/s]:\n");
+		limit = 1.0;
+		for (i=0; i<HIST_NUM; i++) {
+			if (i < HIST_NUM-1)
+				printf("  < %-8.0f %lu\n", limit, hist[i]);
+			else
+				printf("  >=%-8.0f %lu\n", limit / 10.0, hist[i]);
+			limit *= 10.0;
+		}
+	}
+	else
+		printf("edge rate: unknown timestamp rate (z73_capture -r=<rate>)\n");
+
+	return(0);
+}
+
+/********************************* Get32 ***********************************/
+/** Read 32 bit value in file byte order
+ *
+ *  \param p          \IN  data
+ *
+ *  \return           value
+ */
+static u32 Get32( const unsigned char *p )
+{
+	u32 v;
+
+	memcpy(&v, p, 4);
+	if (G_swap)
+		v = (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+	return(v);
+}
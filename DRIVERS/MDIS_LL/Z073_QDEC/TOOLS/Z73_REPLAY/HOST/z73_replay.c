@@ -0,0 +1,1172 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   Z73_REPLAY                       ************
+ ************                                                    ************
+ ****************************************************************************/
+/*!
+ *         \file z73_replay.c
+ *       \author Christian.Schuster@men.de
+ *
+ *       \brief  Replay a Z73 register access log on the host
+ *
+ *               Feeds a log written by "z73_trace -m" (driver built with
+ *               Z73_MMIO_LOG) back into the unmodified driver code, which
+ *               is included here together with OSS and DESC replacements:
+ *
+ *               - the ISR, the alarm routines and the Read/GetStat/SetStat
+ *                 calls are invoked in the recorded order, block data of
+ *                 the calls is taken from the log
+ *               - every register read returns the recorded value, every
+ *                 write is compared with the recorded one
+ *               - OSS_TickGet() returns the recorded timestamp
+ *               - an interrupt or alarm logged inside a call is invoked at
+ *                 the same register access, as it preempted the call on
+ *                 the target
+ *               - each recorded task (Z73_MMIO_REC.tid) calls the driver
+ *                 from its own host thread; only one thread runs at a time
+ *                 and the log decides when to switch, so calls of several
+ *                 tasks overlap as they did on the target
+ *               - a semaphore wait which blocked on the target dispatches
+ *                 the following interrupts, alarms and calls of other
+ *                 tasks until the semaphore is signaled; it times out when
+ *                 its own task continues in the log
+ *
+ *               Accesses which don't match the log are counted as
+ *               divergences, usually the descriptor settings of the target
+ *               differ (-d). The replay runs as fast as possible or paced
+ *               at the recorded speed multiplied by -s. The host time of
+ *               each path (incl. preempting calls) and the fill and
+ *               overflows of the status queues are reported.
+ *
+ *               Records of a task which ran on another CPU during an
+ *               interrupt or alarm can't be separated from these and
+ *               count as divergences.
+ *
+ *               Build on the host with the MDIS headers, e.g.
+ *               "cc -I<MDIS>/INCLUDE/COM -o z73_replay z73_replay.c
+ *               -lpthread".
+ *               The log must have the byte order of the host.
+ *
+ *     Required: -
+ *     \switches (none)
+ *
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+ /*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <time.h>
+#include <pthread.h>
+#include <MEN/men_typs.h>
+
+/*--------------------------------------+
+|   DRIVER                              |
++--------------------------------------*/
+#ifndef _LL_DRV_
+# define _LL_DRV_
+#endif
+#ifndef MAC_MEM_MAPPED
+# define MAC_MEM_MAPPED
+#endif
+#ifndef MAK_REVISION
+# define MAK_REVISION z73_replay
+#endif
+
+/* register accesses are served from the log, nothing is logged */
+#define Z73_RD(h,off)           ReplayRd( (off) )
+#define Z73_WR(h,off,v)         ReplayWr( (off), (v) )
+#define Z73_MMIO_EV(h,t,a)
+#define Z73_MMIO_API(h,t,c,v)
+
+/* the recorded timestamps are returned by OSS_TickGet() */
+#define Z73_TIMESTAMP(h)        OSS_TickGet( (h)->osHdl )
+#define Z73_TIMESTAMP_RATE(h)   OSS_TickRateGet( (h)->osHdl )
+
+static u_int32 ReplayRd( u_int32 off );
+static void ReplayWr( u_int32 off, u_int32 val );
+
+#include "../../../DRIVER/COM/z73_drv.c"
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define PATH_MAX_NUM	64			/**< distinct paths reported */
+#define KEY_MAX_NUM		32			/**< descriptor keys (-d) */
+#define BLK_MAX			0x100000	/**< max. block size of a call */
+#define DIV_PRINT		20			/**< divergences printed with -v */
+#define THR_MAX_NUM		16			/**< calling tasks replayed */
+
+/** calling context, decides what may preempt */
+#define CTX_INIT		0
+#define CTX_API			1
+#define CTX_ALARM		2
+#define CTX_IRQ			3
+
+/*--------------------------------------+
+|   TYPDEFS                             |
++--------------------------------------*/
+/** timing of one path */
+typedef struct {
+	u_int16		type;		/**< Z073_MMIO_IRQ/ALARM/GETSTAT/SETSTAT/READ */
+	u_int32		code;		/**< status code, channel or alarm */
+	u_int32		n;			/**< calls */
+	double		sum;		/**< total time [us] */
+	double		min;		/**< min. time [us] */
+	double		max;		/**< max. time [us] */
+} PATH_STAT;
+
+/** descriptor key given with -d */
+typedef struct {
+	char		*name;
+	u_int32		val;
+	int			used;
+} KEY_VAL;
+
+/** OSS object replacements */
+typedef struct {
+	int32		type;		/**< OSS_SEM_BIN/COUNT */
+	int32		cnt;
+} REPLAY_SEM;
+
+typedef struct {
+	void		(*funct)(void *arg);
+	void		*arg;
+	u_int32		armed;
+} REPLAY_ALARM;
+
+/** host thread of a recorded calling task */
+typedef struct {
+	u_int32		tid;		/**< recorded task id */
+	pthread_t	thr;
+	const Z73_MMIO_REC *call;	/**< call in progress, NULL=idle */
+} REPLAY_THREAD;
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+static Z73_MMIO_REC	*G_rec;			/**< log records */
+static u_int32		G_num;			/**< number of records */
+static u_int32		G_cur;			/**< next record */
+static int			G_end;			/**< no more records are replayed */
+static int			G_check;		/**< compare accesses with the log */
+static int			G_ctx;			/**< current context (CTX_xxx) */
+static int			G_verbose;
+static u_int32		G_now;			/**< recorded time [ticks] */
+static u_int32		G_tickRate;		/**< ticks per second */
+static u_int32		G_reg[4];		/**< last register values */
+static LL_HANDLE	*G_hdl;
+
+static PATH_STAT	G_path[PATH_MAX_NUM];
+static u_int32		G_pathNum;
+static KEY_VAL		G_key[KEY_MAX_NUM];
+static u_int32		G_keyNum;
+
+/* statistics */
+static u_int32		G_diverge, G_firstDiv;
+static u_int32		G_stray, G_lost, G_irqNotMe, G_sigSent, G_evRead;
+static u_int32		G_overflow, G_btnMax, G_movMax, G_movDepthMax, G_samples;
+static double		G_fillSum;
+
+static char			G_dummy;		/**< target of dummy handles */
+
+/* calling tasks, the thread in G_run (NULL=main) holds the baton */
+static REPLAY_THREAD	G_thr[THR_MAX_NUM];
+static u_int32			G_thrNum;
+static REPLAY_THREAD	*G_run;
+static int				G_quit;
+static pthread_mutex_t	G_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t	G_cond = PTHREAD_COND_INITIALIZER;
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static int Load( const char *file, u_int32 *tickRateP );
+static void Dispatch( const Z73_MMIO_REC *r );
+static int32 CallStat( const Z73_MMIO_REC *r );
+static const Z73_MMIO_REC *Expect( u_int16 type, u_int32 off );
+static int Preempts( const Z73_MMIO_REC *r );
+static int Foreign( const Z73_MMIO_REC *r );
+static const Z73_MMIO_REC *Next( void );
+static REPLAY_THREAD *ThreadGet( u_int32 tid, int create );
+static void *ThreadMain( void *arg );
+static void Switch( REPLAY_THREAD *to );
+static void Diverge( u_int16 type, u_int32 off, u_int32 val,
+					 const Z73_MMIO_REC *r );
+static void QueueStats( void );
+static void PathAdd( u_int16 type, u_int32 code, double us );
+static void Pace( u_int32 ts, u_int32 ts0, double speed,
+				  const struct timespec *start );
+static double Elapsed( const struct timespec *t0 );
+static const char *TypeName( u_int16 type );
+static void Report( u_int32 ts0, const struct timespec *start );
+
+/********************************* main ************************************/
+/** Program main function
+ *
+ *  \param argc       \IN  argument counter
+ *  \param argv       \IN  argument vector
+ *
+ *  \return           success (0), error (1) or divergences (2)
+ */
+int main( int argc, char *argv[] )
+{
+	char			*file = NULL, *eq;
+	double			speed = 0.0;
+	u_int32			rate = 0, ts0, i;
+	MACCESS			ma;
+	struct timespec	start;
+	const Z73_MMIO_REC *r;
+	REPLAY_THREAD	*t;
+	int32			error;
+	int				n;
+
+	for (n=1; n<argc; n++) {
+		if (strncmp(argv[n], "-s=", 3) == 0)
+			speed = atof(argv[n] + 3);
+		else if (strncmp(argv[n], "-r=", 3) == 0)
+			rate = (u_int32)strtoul(argv[n] + 3, NULL, 0);
+		else if (strncmp(argv[n], "-d=", 3) == 0 &&
+				 (eq = strchr(argv[n] + 3, '=')) != NULL &&
+				 G_keyNum < KEY_MAX_NUM) {
+			*eq = '\0';
+			G_key[G_keyNum].name = argv[n] + 3;
+			G_key[G_keyNum].val  = (u_int32)strtoul(eq + 1, NULL, 0);
+			G_keyNum++;
+		}
+		else if (strcmp(argv[n], "-v") == 0)
+			G_verbose = 1;
+		else if (*argv[n] != '-' && !file)
+			file = argv[n];
+		else {
+			file = NULL;
+			break;
+		}
+	}
+
+	if (!file) {
+		printf("Syntax: z73_replay <file> [opts]\n");
+		printf("Function: replay Z73 register access log "
+			   "(z73_trace -m)\n");
+		printf("Options:\n");
+		printf("    file           log file\n");
+		printf("    [-s=<speed>]   recorded speed * <speed>, "
+			   "0=as fast as possible [0]\n");
+		printf("    [-r=<rate>]    timestamp ticks per second "
+			   "[from log]\n");
+		printf("    [-d=<key>=<v>] descriptor key of the target, "
+			   "e.g. -d=Z073_DEFERRED=1\n");
+		printf("    [-v]           print each call and divergence\n");
+		return(1);
+	}
+
+	if (Load(file, &rate))
+		return(1);
+
+	/* replay starts at the (first) driver init */
+	for (i=0; i<G_num && G_rec[i].type != Z073_MMIO_START; i++)
+		;
+	if (i == G_num) {
+		fprintf(stderr, "*** %s: no Z073_MMIO_START record, log must be "
+				"read from driver init on\n", file);
+		return(1);
+	}
+	if (i)
+		printf("skipping %u records before driver init\n", (unsigned)i);
+
+	G_tickRate = rate ? rate : G_rec[i].a;
+	if (!G_tickRate) {
+		printf("tick rate unknown (-r=<rate>), 1000 assumed\n");
+		G_tickRate = 1000;
+	}
+
+	ts0    = G_rec[i].ts;
+	G_now  = ts0;
+	G_cur  = i + 1;
+
+	/*--------------------+
+	|  init driver        |
+	+--------------------*/
+	memset(&ma, 0, sizeof(ma));
+	G_check = 1;
+	G_ctx   = CTX_INIT;
+	if ((error = Z73_Init((DESC_SPEC*)&G_dummy, (OSS_HANDLE*)&G_dummy, &ma,
+						  (OSS_SEM_HANDLE*)&G_dummy, (OSS_IRQ_HANDLE*)&G_dummy,
+						  &G_hdl))) {
+		fprintf(stderr, "*** Z73_Init failed: 0x%04x\n", (unsigned)error);
+		return(1);
+	}
+
+	for (i=0; i<G_keyNum; i++)
+		if (!G_key[i].used)
+			printf("descriptor key %s not used by the driver\n",
+				   G_key[i].name);
+
+	/*--------------------+
+	|  replay             |
+	+--------------------*/
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	while ((r = Next()) != NULL) {
+		if (r->type == Z073_MMIO_START) {
+			printf("driver re-initialized at record %u, replay stopped\n",
+				   (unsigned)G_cur);
+			break;
+		}
+
+		Pace(r->ts, ts0, speed, &start);
+
+		switch (r->type) {
+		case Z073_MMIO_READ:
+		case Z073_MMIO_GETSTAT:
+		case Z073_MMIO_SETSTAT:
+			/* new call, or the busy task didn't return on the target */
+			if ((t = ThreadGet(r->tid, 1)) == NULL) {
+				fprintf(stderr, "*** can't replay task %u (max. %u tasks)\n",
+						(unsigned)r->tid, THR_MAX_NUM);
+				G_end = 1;
+				break;
+			}
+			if (!t->call)
+				t->call = &G_rec[G_cur++];
+			Switch(t);
+			break;
+		case Z073_MMIO_IRQ:
+		case Z073_MMIO_ALARM:
+		case Z073_MMIO_LOST:
+			G_cur++;
+			G_ctx = CTX_API;
+			Dispatch(r);
+			QueueStats();
+			break;
+		default:
+			/* continues a call which is switched out */
+			if ((t = ThreadGet(r->tid, 0)) != NULL && t->call)
+				Switch(t);
+			else {
+				G_cur++;
+				Dispatch(r);
+			}
+		}
+	}
+
+	/* complete the calls still in progress, then stop the threads */
+	G_end = 1;
+	for (i=0; i<G_thrNum; i++)
+		if (G_thr[i].call)
+			Switch(&G_thr[i]);
+	G_quit = 1;
+	for (i=0; i<G_thrNum; i++) {
+		Switch(&G_thr[i]);
+		pthread_join(G_thr[i].thr, NULL);
+	}
+
+	Report(ts0, &start);
+
+	/* exit without comparing with the log */
+	G_check = 0;
+	Z73_Exit(&G_hdl);
+
+	return(G_diverge ? 2 : 0);
+}
+
+/********************************* Load ************************************/
+/** Read the log file
+ *
+ *  \param file       \IN  file name
+ *  \param tickRateP  \IN  tick rate given (0=take from file)
+ *                    \OUT tick rate
+ *
+ *  \return           success (0) or error (1)
+ */
+static int Load( const char *file, u_int32 *tickRateP )
+{
+	FILE		*fp;
+	Z73_TRC_HDR	hdr;
+	long		size;
+
+	if ((fp = fopen(file, "rb")) == NULL) {
+		perror(file);
+		return(1);
+	}
+
+	if (fread(&hdr, sizeof(hdr), 1, fp) != 1 ||
+		hdr.magic != Z073_MMIO_MAGIC) {
+		fprintf(stderr, "*** %s: not a Z73 register log of this byte "
+				"order\n", file);
+		fclose(fp);
+		return(1);
+	}
+	if (hdr.version != Z073_MMIO_VERSION ||
+		hdr.recSize != sizeof(Z73_MMIO_REC)) {
+		fprintf(stderr, "*** %s: unsupported version %u / record size %u\n",
+				file, (unsigned)hdr.version, (unsigned)hdr.recSize);
+		fclose(fp);
+		return(1);
+	}
+	if (!*tickRateP)
+		*tickRateP = hdr.tickRate;
+
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp) - (long)sizeof(hdr);
+	fseek(fp, (long)sizeof(hdr), SEEK_SET);
+
+	G_num = (u_int32)(size / (long)sizeof(Z73_MMIO_REC));
+	if (!G_num || (G_rec = (Z73_MMIO_REC*)malloc(
+					   G_num * sizeof(Z73_MMIO_REC))) == NULL ||
+		fread(G_rec, sizeof(Z73_MMIO_REC), G_num, fp) != G_num) {
+		fprintf(stderr, "*** %s: no records\n", file);
+		fclose(fp);
+		return(1);
+	}
+	fclose(fp);
+
+	return(0);
+}
+
+/********************************* Dispatch ********************************/
+/** Invoke the driver for a recorded entry
+ *
+ *  \param r          \IN  record
+ */
+static void Dispatch( const Z73_MMIO_REC *r )
+{
+	struct timespec	t0;
+	int				ctx = G_ctx;
+	u_int32			code = 0;
+	int32			ret = 0;
+	double			us;
+
+	G_now = r->ts;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+
+	switch (r->type) {
+	case Z073_MMIO_IRQ:
+		G_ctx = CTX_IRQ;
+		if (Z73_Irq(G_hdl) == LL_IRQ_DEV_NOT)
+			G_irqNotMe++;
+		break;
+	case Z073_MMIO_ALARM:
+		G_ctx = CTX_ALARM;
+		code  = r->a;
+		if (code == Z073_MMIO_ALM_DEFER && G_hdl->deferAlarm)
+			deferProcess(G_hdl);
+		else if (code == Z073_MMIO_ALM_GESTURE && G_hdl->gestAlarm)
+			gestureAlarm(G_hdl);
+		else if (code == Z073_MMIO_ALM_SIGLAT && G_hdl->sigLatAlarm)
+			sigLatAlarm(G_hdl);
+		else if (code == Z073_MMIO_ALM_WDOG && G_hdl->wdogAlarm)
+			wdogAlarm(G_hdl);
+		else if (code == Z073_MMIO_ALM_QGROW && G_hdl->qGrowAlarm)
+			qGrowAlarm(G_hdl);
+		else
+			Diverge(r->type, code, 0, r);
+		break;
+	case Z073_MMIO_READ:
+	case Z073_MMIO_GETSTAT:
+	case Z073_MMIO_SETSTAT:
+		G_ctx = CTX_API;
+		code  = r->a;
+		ret   = CallStat(r);
+		break;
+	case Z073_MMIO_LOST:
+		G_lost += r->a;
+		return;
+	default:
+		/* access or data outside of a call: replay took another path */
+		G_stray++;
+		Diverge(r->type, r->a, r->b, r);
+		return;
+	}
+
+	us = Elapsed(&t0) * 1e6;
+	G_ctx = ctx;
+	PathAdd(r->type, code, us);
+
+	if (G_verbose)
+		printf("%6u %10u %5u %-8s 0x%08x %9.2fus ret=0x%04x fill=%u\n",
+			   (unsigned)(r - G_rec), (unsigned)r->ts, (unsigned)r->tid,
+			   TypeName(r->type),
+			   (unsigned)code, us, (unsigned)ret,
+			   (unsigned)Z73_STATUSQ_FILL(G_hdl));
+}
+
+/********************************* CallStat ********************************/
+/** Replay a Read/GetStat/SetStat call
+ *
+ *  The block of a block code is built from the following
+ *  Z073_MMIO_DATA records.
+ *
+ *  \param r          \IN  record
+ *
+ *  \return           driver return value
+ */
+static int32 CallStat( const Z73_MMIO_REC *r )
+{
+	M_SG_BLOCK	blk;
+	const Z73_MMIO_REC *d;
+	INT32_OR_64	val = 0;
+	int32		v32 = 0, ret;
+	u_int32		size = r->b;
+	char		*buf = NULL;
+
+	if (r->type == Z073_MMIO_READ) {
+		ret = Z73_Read(G_hdl, (int32)r->a, &v32);
+		return(ret);
+	}
+
+	if (!Z73_IS_BLK(r->a)) {
+		if (r->type == Z073_MMIO_SETSTAT)
+			return(Z73_SetStat(G_hdl, (int32)r->a, 0,
+							   (INT32_OR_64)(int32)r->b));
+
+		ret = Z73_GetStat(G_hdl, (int32)r->a, 0, &val);
+		if (ret == 0 && r->a == Z073_STATUS)
+			G_evRead++;
+		return(ret);
+	}
+
+	if (size > BLK_MAX || (buf = (char*)calloc(1, size ? size : 1)) == NULL) {
+		Diverge(r->type, r->a, size, r);
+		return(ERR_LL_USERBUF);
+	}
+
+	while ((d = Next()) != NULL && d->type == Z073_MMIO_DATA &&
+		   d->tid == r->tid) {
+		if (d->a + 4 <= size)
+			memcpy(buf + d->a, &d->b, 4);
+		G_cur++;
+	}
+
+	blk.size = (int32)size;
+	blk.data = (void*)buf;
+
+	if (r->type == Z073_MMIO_SETSTAT)
+		ret = Z73_SetStat(G_hdl, (int32)r->a, 0, (INT32_OR_64)&blk);
+	else {
+		ret = Z73_GetStat(G_hdl, (int32)r->a, 0, (INT32_OR_64*)&blk);
+		if (ret == 0 && r->a == Z073_BLK_EVENTS)
+			G_evRead += (u_int32)blk.size / sizeof(Z73_EVENT);
+	}
+
+	free(buf);
+	return(ret);
+}
+
+/********************************* ReplayRd ********************************/
+/** Register read of the driver
+ *
+ *  \param off        \IN  register offset
+ *
+ *  \return           recorded value, last value if not matching the log
+ */
+static u_int32 ReplayRd( u_int32 off )
+{
+	const Z73_MMIO_REC *r = Expect(Z073_MMIO_RD, off);
+	u_int32 *reg = &G_reg[(off >> 2) & 3];
+
+	if (r) {
+		*reg = r->b;
+		return(r->b);
+	}
+
+	/* position counter is cleared by reading */
+	return(off == Z073_POS_CNT ? 0 : *reg);
+}
+
+/********************************* ReplayWr ********************************/
+/** Register write of the driver
+ *
+ *  \param off        \IN  register offset
+ *  \param val        \IN  value written
+ */
+static void ReplayWr( u_int32 off, u_int32 val )
+{
+	const Z73_MMIO_REC *r = Expect(Z073_MMIO_WR, off);
+
+	if (r && r->b != val)
+		Diverge(Z073_MMIO_WR, off, val, r);
+
+	if (off == Z073_IRQ_EN)
+		G_reg[(off >> 2) & 3] = val;
+}
+
+/********************************* Expect **********************************/
+/** Consume the record of a register access
+ *
+ *  Interrupts and alarms logged before the access preempted the current
+ *  call on the target and are invoked first. Records of other tasks
+ *  before the access ran while the call was preempted on the target,
+ *  the thread is switched out until its task continues.
+ *
+ *  \param type       \IN  Z073_MMIO_RD/WR
+ *  \param off        \IN  register offset
+ *
+ *  \return           record or NULL if the log doesn't match
+ */
+static const Z73_MMIO_REC *Expect( u_int16 type, u_int32 off )
+{
+	const Z73_MMIO_REC *r;
+
+	if (!G_check)
+		return(NULL);
+
+	while ((r = Next()) != NULL) {
+		if (Preempts(r)) {
+			G_cur++;
+			Dispatch(r);
+		}
+		else if (Foreign(r))
+			Switch(NULL);
+		else
+			break;
+	}
+
+	if (r && r->type == type && r->a == off) {
+		G_cur++;
+		G_now = r->ts;
+		return(r);
+	}
+
+	Diverge(type, off, 0, r);
+	return(NULL);
+}
+
+/********************************* Preempts ********************************/
+/** Check if a record can preempt the current context
+ *
+ *  \param r          \IN  record
+ *
+ *  \return           1 if the record interrupts the current context
+ */
+static int Preempts( const Z73_MMIO_REC *r )
+{
+	switch (r->type) {
+	case Z073_MMIO_IRQ:
+		return(G_ctx == CTX_API || G_ctx == CTX_ALARM);
+	case Z073_MMIO_ALARM:
+		return(G_ctx == CTX_API);
+	default:
+		return(0);
+	}
+}
+
+/********************************* Foreign *********************************/
+/** Check if a record belongs to another task than the current call
+ *
+ *  Interrupts and alarms run on the target without switching tasks, their
+ *  records are consumed in order.
+ *
+ *  \param r          \IN  record
+ *
+ *  \return           1 if the current thread has to be switched out
+ */
+static int Foreign( const Z73_MMIO_REC *r )
+{
+	return(G_run && G_ctx == CTX_API && r->tid != G_run->tid);
+}
+
+/********************************* Next ************************************/
+/** Next record to replay
+ *
+ *  \return           record or NULL at the end of the replay
+ */
+static const Z73_MMIO_REC *Next( void )
+{
+	return((G_cur < G_num && !G_end) ? &G_rec[G_cur] : NULL);
+}
+
+/********************************* ThreadGet *******************************/
+/** Get the host thread of a recorded task
+ *
+ *  \param tid        \IN  recorded task id
+ *  \param create     \IN  start a thread for a new task
+ *
+ *  \return           thread or NULL
+ */
+static REPLAY_THREAD *ThreadGet( u_int32 tid, int create )
+{
+	REPLAY_THREAD *t;
+	u_int32 i;
+
+	for (i=0; i<G_thrNum; i++)
+		if (G_thr[i].tid == tid)
+			return(&G_thr[i]);
+
+	if (!create || G_thrNum == THR_MAX_NUM)
+		return(NULL);
+
+	t = &G_thr[G_thrNum];
+	t->tid  = tid;
+	t->call = NULL;
+	if (pthread_create(&t->thr, NULL, ThreadMain, t))
+		return(NULL);
+	G_thrNum++;
+	return(t);
+}
+
+/********************************* ThreadMain ******************************/
+/** Host thread of a recorded task, replays its calls
+ *
+ *  \param arg        \IN  REPLAY_THREAD
+ *
+ *  \return           NULL
+ */
+static void *ThreadMain( void *arg )
+{
+	REPLAY_THREAD *t = (REPLAY_THREAD*)arg;
+
+	pthread_mutex_lock(&G_lock);
+	while (G_run != t)
+		pthread_cond_wait(&G_cond, &G_lock);
+	pthread_mutex_unlock(&G_lock);
+
+	while (!G_quit) {
+		G_ctx = CTX_API;
+		Dispatch(t->call);
+		t->call = NULL;
+		QueueStats();
+		Switch(NULL);
+	}
+
+	/* hand the baton back for good */
+	pthread_mutex_lock(&G_lock);
+	G_run = NULL;
+	pthread_cond_broadcast(&G_cond);
+	pthread_mutex_unlock(&G_lock);
+	return(NULL);
+}
+
+/********************************* Switch **********************************/
+/** Pass the baton to another thread and wait until it comes back
+ *
+ *  \param to         \IN  thread to run, NULL=main
+ */
+static void Switch( REPLAY_THREAD *to )
+{
+	REPLAY_THREAD *self = G_run;
+	int ctx = G_ctx;
+
+	pthread_mutex_lock(&G_lock);
+	G_run = to;
+	pthread_cond_broadcast(&G_cond);
+	while (G_run != self)
+		pthread_cond_wait(&G_cond, &G_lock);
+	pthread_mutex_unlock(&G_lock);
+
+	G_ctx = ctx;
+}
+
+/********************************* Diverge *********************************/
+/** Count a replay divergence
+ *
+ *  \param type       \IN  access or record type
+ *  \param off        \IN  offset or code
+ *  \param val        \IN  value
+ *  \param r          \IN  log record compared, NULL=end of log
+ */
+static void Diverge( u_int16 type, u_int32 off, u_int32 val,
+					 const Z73_MMIO_REC *r )
+{
+	u_int32 idx = r ? (u_int32)(r - G_rec) : G_num;
+
+	if (!G_diverge++)
+		G_firstDiv = idx;
+
+	if (G_verbose && G_diverge <= DIV_PRINT) {
+		printf("--- divergence at record %u: driver %s 0x%02x val=0x%08x, "
+			   "log ", (unsigned)idx, TypeName(type), (unsigned)off,
+			   (unsigned)val);
+		if (r)
+			printf("%s 0x%02x val=0x%08x\n", TypeName(r->type),
+				   (unsigned)r->a, (unsigned)r->b);
+		else
+			printf("end\n");
+	}
+}
+
+/********************************* QueueStats ******************************/
+/** Sample the status queues after a top level call
+ */
+static void QueueStats( void )
+{
+	u_int32 btn = Z73_Q_FILL(&G_hdl->btnQ);
+	u_int32 mov = Z73_Q_FILL(&G_hdl->movQ);
+	u_int32 depth = Z73_Q_DEPTH(&G_hdl->movQ);
+
+	if (btn > G_btnMax)
+		G_btnMax = btn;
+	if (mov > G_movMax)
+		G_movMax = mov;
+	if (depth > G_movDepthMax)
+		G_movDepthMax = depth;
+
+	G_fillSum += btn + mov;
+	G_samples++;
+
+	/* entries dropped, button queue was full */
+	G_overflow = G_hdl->btnDropped;
+}
+
+/********************************* PathAdd *********************************/
+/** Account the time of a path
+ *
+ *  \param type       \IN  record type
+ *  \param code       \IN  status code, channel or alarm
+ *  \param us         \IN  time [us]
+ */
+static void PathAdd( u_int16 type, u_int32 code, double us )
+{
+	PATH_STAT *p;
+	u_int32 i;
+
+	for (i=0; i<G_pathNum; i++)
+		if (G_path[i].type == type && G_path[i].code == code)
+			break;
+
+	if (i == G_pathNum) {
+		if (G_pathNum == PATH_MAX_NUM)
+			return;
+		p = &G_path[G_pathNum++];
+		p->type = type;
+		p->code = code;
+		p->min  = us;
+	}
+	p = &G_path[i];
+
+	p->n++;
+	p->sum += us;
+	if (us < p->min)
+		p->min = us;
+	if (us > p->max)
+		p->max = us;
+}
+
+/********************************* Pace ************************************/
+/** Wait until a record is due
+ *
+ *  \param ts         \IN  record timestamp
+ *  \param ts0        \IN  timestamp of replay start
+ *  \param speed      \IN  speed factor, 0=don't wait
+ *  \param start      \IN  host time of replay start
+ */
+static void Pace( u_int32 ts, u_int32 ts0, double speed,
+				  const struct timespec *start )
+{
+	struct timespec	d;
+	double			wait;
+
+	if (speed <= 0.0)
+		return;
+
+	wait = (double)(u_int32)(ts - ts0) / G_tickRate / speed - Elapsed(start);
+	if (wait <= 0.0)
+		return;
+
+	d.tv_sec  = (time_t)wait;
+	d.tv_nsec = (long)((wait - (double)d.tv_sec) * 1e9);
+	nanosleep(&d, NULL);
+}
+
+/********************************* Elapsed *********************************/
+/** Host time since t0
+ *
+ *  \param t0         \IN  start time
+ *
+ *  \return           seconds
+ */
+static double Elapsed( const struct timespec *t0 )
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return((double)(t.tv_sec - t0->tv_sec) +
+		   (double)(t.tv_nsec - t0->tv_nsec) * 1e-9);
+}
+
+/********************************* TypeName ********************************/
+/** Name of a record type
+ *
+ *  \param type       \IN  record type
+ *
+ *  \return           name
+ */
+static const char *TypeName( u_int16 type )
+{
+	static const char *name[] = {
+		"?", "START", "RD", "WR", "IRQ", "ALARM", "GETSTAT", "SETSTAT",
+		"READ", "DATA", "LOST"
+	};
+
+	return(type < sizeof(name)/sizeof(name[0]) ? name[type] : "?");
+}
+
+/********************************* Report **********************************/
+/** Print the replay results
+ *
+ *  \param ts0        \IN  timestamp of replay start
+ *  \param start      \IN  host time of replay start
+ */
+static void Report( u_int32 ts0, const struct timespec *start )
+{
+	u_int32 i, last = G_rec[(G_cur ? G_cur : 1) - 1].ts;
+	double host = Elapsed(start);
+
+	printf("records:               %u (lost on target: %u)\n",
+		   (unsigned)G_num, (unsigned)G_lost);
+	printf("recorded time:         %.3f s\n",
+		   (double)(u_int32)(last - ts0) / G_tickRate);
+	printf("replay time:           %.3f s\n", host);
+	printf("divergences:           %u", (unsigned)G_diverge);
+	if (G_diverge)
+		printf(" (first at record %u, %u stray records)",
+			   (unsigned)G_firstDiv, (unsigned)G_stray);
+	printf("\n");
+	printf("irqs not from device:  %u\n", (unsigned)G_irqNotMe);
+	printf("signals sent:          %u\n", (unsigned)G_sigSent);
+	printf("status entries read:   %u\n", (unsigned)G_evRead);
+	printf("button entries dropped: %u\n", (unsigned)G_overflow);
+	printf("max. fill btn/mov:     %u / %u (mov depth %u, max. %u)\n",
+		   (unsigned)G_btnMax, (unsigned)G_movMax,
+		   (unsigned)Z73_Q_DEPTH(&G_hdl->movQ), (unsigned)G_movDepthMax);
+	printf("avg. fill:             %.2f\n",
+		   G_samples ? G_fillSum / G_samples : 0.0);
+
+	printf("\n%-8s %-10s %8s %10s %10s %10s\n",
+		   "path", "code", "calls", "min[us]", "avg[us]", "max[us]");
+	for (i=0; i<G_pathNum; i++)
+		printf("%-8s 0x%08x %8u %10.2f %10.2f %10.2f\n",
+			   TypeName(G_path[i].type), (unsigned)G_path[i].code,
+			   (unsigned)G_path[i].n, G_path[i].min,
+			   G_path[i].sum / G_path[i].n, G_path[i].max);
+	printf("(times include preempting irqs/alarms and overlapping calls)\n");
+}
+
+/*--------------------------------------+
+|   OSS/DESC REPLACEMENTS               |
++--------------------------------------*/
+char* OSS_Ident( void )
+{
+	return("OSS replay");
+}
+
+void* OSS_MemGet( OSS_HANDLE *osHdl, u_int32 size, u_int32 *gotsizeP )
+{
+	*gotsizeP = size;
+	return(malloc(size));
+}
+
+int32 OSS_MemFree( OSS_HANDLE *osHdl, void *addr, u_int32 size )
+{
+	free(addr);
+	return(0);
+}
+
+void OSS_MemFill( OSS_HANDLE *osHdl, u_int32 size, char *adr, int8 value )
+{
+	memset(adr, value, size);
+}
+
+void OSS_MemCopy( OSS_HANDLE *osHdl, u_int32 size, char *src, char *dest )
+{
+	memcpy(dest, src, size);
+}
+
+OSS_IRQ_STATE OSS_IrqMaskR( OSS_HANDLE *osHdl, OSS_IRQ_HANDLE *irqHdl )
+{
+	OSS_IRQ_STATE state;
+
+	memset(&state, 0, sizeof(state));
+	return(state);
+}
+
+void OSS_IrqRestore( OSS_HANDLE *osHdl, OSS_IRQ_HANDLE *irqHdl,
+					 OSS_IRQ_STATE state )
+{
+}
+
+u_int32 OSS_TickGet( OSS_HANDLE *osHdl )
+{
+	return(G_now);
+}
+
+u_int32 OSS_TickRateGet( OSS_HANDLE *osHdl )
+{
+	return(G_tickRate);
+}
+
+int32 OSS_SemCreate( OSS_HANDLE *osHdl, int32 semType, int32 initVal,
+					 OSS_SEM_HANDLE **semP )
+{
+	REPLAY_SEM *sem = (REPLAY_SEM*)calloc(1, sizeof(REPLAY_SEM));
+
+	if (!sem)
+		return(ERR_OSS_MEM_ALLOC);
+	sem->type = semType;
+	sem->cnt  = initVal;
+	*semP = (OSS_SEM_HANDLE*)sem;
+	return(0);
+}
+
+int32 OSS_SemRemove( OSS_HANDLE *osHdl, OSS_SEM_HANDLE **semP )
+{
+	free(*semP);
+	*semP = NULL;
+	return(0);
+}
+
+/* a blocked waiter lets the log run (interrupts, alarms, other tasks)
+ * until the semaphore is signaled, it timed out on the target when its
+ * own task continues first */
+int32 OSS_SemWait( OSS_HANDLE *osHdl, OSS_SEM_HANDLE *semHdl, int32 msec )
+{
+	REPLAY_SEM *sem = (REPLAY_SEM*)semHdl;
+	const Z73_MMIO_REC *r;
+
+	while (sem->cnt <= 0 && msec != OSS_SEM_NOWAIT && G_check &&
+		   (r = Next()) != NULL) {
+		if (r->type == Z073_MMIO_IRQ || r->type == Z073_MMIO_ALARM) {
+			G_cur++;
+			Dispatch(r);
+		}
+		else if (Foreign(r))
+			Switch(NULL);
+		else
+			break;
+	}
+
+	if (sem->cnt <= 0)
+		return(ERR_OSS_TIMEOUT);
+	sem->cnt--;
+	return(0);
+}
+
+int32 OSS_SemSignal( OSS_HANDLE *osHdl, OSS_SEM_HANDLE *semHdl )
+{
+	REPLAY_SEM *sem = (REPLAY_SEM*)semHdl;
+
+	if (sem->type == OSS_SEM_BIN)
+		sem->cnt = 1;
+	else
+		sem->cnt++;
+	return(0);
+}
+
+int32 OSS_SigCreate( OSS_HANDLE *osHdl, int32 value, OSS_SIG_HANDLE **sigP )
+{
+	*sigP = (OSS_SIG_HANDLE*)malloc(sizeof(int32));
+	return(*sigP ? 0 : ERR_OSS_MEM_ALLOC);
+}
+
+int32 OSS_SigSend( OSS_HANDLE *osHdl, OSS_SIG_HANDLE *sig )
+{
+	G_sigSent++;
+	return(0);
+}
+
+int32 OSS_SigRemove( OSS_HANDLE *osHdl, OSS_SIG_HANDLE **sigP )
+{
+	free(*sigP);
+	*sigP = NULL;
+	return(0);
+}
+
+/* alarm routines are called from the Z073_MMIO_ALARM records */
+int32 OSS_AlarmCreate( OSS_HANDLE *osHdl, void (*funct)(void *arg),
+					   void *arg, OSS_ALARM_HANDLE **alarmP )
+{
+	REPLAY_ALARM *alm = (REPLAY_ALARM*)calloc(1, sizeof(REPLAY_ALARM));
+
+	if (!alm)
+		return(ERR_OSS_MEM_ALLOC);
+	alm->funct = funct;
+	alm->arg   = arg;
+	*alarmP = (OSS_ALARM_HANDLE*)alm;
+	return(0);
+}
+
+int32 OSS_AlarmRemove( OSS_HANDLE *osHdl, OSS_ALARM_HANDLE **alarmP )
+{
+	free(*alarmP);
+	*alarmP = NULL;
+	return(0);
+}
+
+int32 OSS_AlarmSet( OSS_HANDLE *osHdl, OSS_ALARM_HANDLE *alarm, u_int32 msec,
+					u_int32 cyclic, u_int32 *realMsecP )
+{
+	((REPLAY_ALARM*)alarm)->armed = 1;
+	*realMsecP = msec;
+	return(0);
+}
+
+int32 OSS_AlarmClear( OSS_HANDLE *osHdl, OSS_ALARM_HANDLE *alarm )
+{
+	((REPLAY_ALARM*)alarm)->armed = 0;
+	return(0);
+}
+
+char* DESC_Ident( void )
+{
+	return("DESC replay");
+}
+
+int32 DESC_Init( DESC_SPEC *descSpec, OSS_HANDLE *osHdl,
+				 DESC_HANDLE **descHandleP )
+{
+	*descHandleP = (DESC_HANDLE*)&G_dummy;
+	return(0);
+}
+
+int32 DESC_Exit( DESC_HANDLE **descHandleP )
+{
+	*descHandleP = NULL;
+	return(0);
+}
+
+void DESC_DbgLevelSet( DESC_HANDLE *descHandle, u_int32 dbgLevel )
+{
+}
+
+/* keys given with -d, all others have their default */
+int32 DESC_GetUInt32( DESC_HANDLE *descHandle, u_int32 defVal,
+					  u_int32 *valueP, char *fmt, ... )
+{
+	char	key[64];
+	va_list	ap;
+	u_int32	i;
+
+	va_start(ap, fmt);
+	vsnprintf(key, sizeof(key), fmt, ap);
+	va_end(ap);
+
+	for (i=0; i<G_keyNum; i++) {
+		if (strcmp(G_key[i].name, key) == 0) {
+			G_key[i].used = 1;
+			*valueP = G_key[i].val;
+			return(0);
+		}
+	}
+
+	*valueP = defVal;
+	return(ERR_DESC_KEY_NOTFOUND);
+}
@@ -0,0 +1,189 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   Z73_TRACE                        ************
+ ************                                                    ************
+ ****************************************************************************/
+/*!
+ *         \file z73_trace.c
+ *       \author Christian.Schuster@men.de
+ *
+ *       \brief  Dump the binary trace ring of the Z73 driver
+ *
+ *               Reads the trace records with Z073_BLK_TRACE and writes
+ *               them unchanged to a file, preceded by a Z73_TRC_HDR. The
+ *               file is decoded on the host with z73_trcdec. The driver
+ *               must be built with Z73_TRACE.
+ *
+ *               With -m the register access log (Z073_BLK_MMIO) is dumped
+ *               instead, the driver must be built with Z73_MMIO_LOG. Use
+ *               -f to read the log while the application runs, the log
+ *               drops new records when full. The file is replayed on the
+ *               host with z73_replay.
+ *
+ *     Required: libraries: mdis_api, usr_oss, usr_utl
+ *     \switches (none)
+ *
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+ /*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <MEN/men_typs.h>
+#include <MEN/usr_oss.h>
+#include <MEN/usr_utl.h>
+#include <MEN/mdis_api.h>
+#include <MEN/mdis_err.h>
+#include <MEN/z73_drv.h>
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define REC_CHUNK	64		/**< records read per getstat */
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static void PrintError(char *info);
+
+/********************************* main ************************************/
+/** Program main function
+ *
+ *  \param argc       \IN  argument counter
+ *  \param argv       \IN  argument vector
+ *
+ *  \return           success (0) or error (1)
+ */
+int main( int argc, char *argv[] )
+{
+	char		*device, *file, *str;
+	MDIS_PATH	path;
+	FILE		*fp;
+	Z73_TRC_HDR	hdr;
+	union {
+		Z73_TRC_REC		trc[REC_CHUNK];
+		Z73_MMIO_REC	mmio[REC_CHUNK];
+	} rec;
+	M_SG_BLOCK	blk;
+	u_int32		looptime, total = 0;
+	int32		follow, mmio, code, n, rate;
+	int			ret = 0;
+
+	if (argc < 3 || strcmp(argv[1],"-?")==0) {
+		printf("Syntax: z73_trace <device> <file> [opts]\n");
+		printf("Function: dump Z73 trace records to <file>\n");
+		printf("Options:\n");
+		printf("    device       device name\n");
+		printf("    file         output file, decode with z73_trcdec\n");
+		printf("    [-m]         dump register access log (z73_replay)\n");
+		printf("    [-f]         follow, read until key pressed\n");
+		printf("    [-t=<ms>]    poll time in follow mode          [100]\n");
+		printf("    [-r=<rate>]  timestamp ticks per second        [driver]  \n");
+		printf("\n");
+		return(1);
+	}
+
+	device = argv[1];
+	file   = argv[2];
+
+	follow   = UTL_TSTOPT("f") ? 1 : 0;
+	mmio     = UTL_TSTOPT("m") ? 1 : 0;
+	looptime = ((str = UTL_TSTOPT("t=")) ? atoi(str) : 100);
+
+	if (mmio) {
+		code        = Z073_BLK_MMIO;
+		hdr.magic   = Z073_MMIO_MAGIC;
+		hdr.version = Z073_MMIO_VERSION;
+		hdr.recSize = sizeof(Z73_MMIO_REC);
+	}
+	else {
+		code        = Z073_BLK_TRACE;
+		hdr.magic   = Z073_TRC_MAGIC;
+		hdr.version = Z073_TRC_VERSION;
+		hdr.recSize = sizeof(Z73_TRC_REC);
+	}
+
+	if ((path = M_open(device)) < 0) {
+		PrintError("open");
+		return(1);
+	}
+
+	/* timestamp rate of the driver unless given */
+	if ((str = UTL_TSTOPT("r=")))
+		hdr.tickRate = atoi(str);
+	else if (M_getstat(path, Z073_TS_RATE, &rate) < 0)
+		hdr.tickRate = 0;
+	else
+		hdr.tickRate = rate;
+
+	if ((fp = fopen(file, "wb")) == NULL) {
+		perror(file);
+		M_close(path);
+		return(1);
+	}
+
+	if (fwrite(&hdr, sizeof(hdr), 1, fp) != 1) {
+		perror(file);
+		ret = 1;
+		goto EXIT;
+	}
+
+	do {
+		/* drain the ring */
+		do {
+			blk.size = REC_CHUNK * hdr.recSize;
+			blk.data = (void*)&rec;
+			if (M_getstat(path, code, (int32*)&blk) < 0) {
+				PrintError(mmio ? "getstat Z073_BLK_MMIO" :
+						   "getstat Z073_BLK_TRACE");
+				ret = 1;
+				goto EXIT;
+			}
+			n = blk.size / hdr.recSize;
+			if (n && fwrite(&rec, hdr.recSize, n, fp) != (size_t)n) {
+				perror(file);
+				ret = 1;
+				goto EXIT;
+			}
+			total += n;
+		} while (n == REC_CHUNK);
+
+		if (follow)
+			UOS_Delay(looptime);
+	} while (follow && UOS_KeyPressed() == -1);
+
+	printf("%u records written to %s\n", (unsigned)total, file);
+
+EXIT:
+	fclose(fp);
+	if (M_close(path) < 0)
+		PrintError("close");
+
+	return(ret);
+}
+
+/********************************* PrintError ******************************/
+/** Print MDIS error message
+ *
+ *  \param info       \IN  info string
+ */
+static void PrintError(char *info)
+{
+	printf("*** can't %s: %s\n", info, M_errstring(UOS_ErrnoGet()));
+}
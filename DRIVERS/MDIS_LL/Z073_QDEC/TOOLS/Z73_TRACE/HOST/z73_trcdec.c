@@ -0,0 +1,199 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   Z73_TRCDEC                       ************
+ ************                                                    ************
+ ****************************************************************************/
+/*!
+ *         \file z73_trcdec.c
+ *       \author Christian.Schuster@men.de
+ *
+ *       \brief  Host decoder for Z73 trace files
+ *
+ *               Decodes a file written by z73_trace on the target. Plain
+ *               ANSI C without MDIS headers, build on the host with
+ *               e.g. "cc -o z73_trcdec z73_trcdec.c". Files written by a
+ *               target of the other byte order are swapped automatically.
+ *               Gaps in the sequence numbers (records overwritten in the
+ *               ring before they were read) are reported.
+ *
+ *     Required: -
+ *     \switches (none)
+ *
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+ /*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+/* must match z73_drv.h */
+#define TRC_MAGIC		0x5a373354
+#define TRC_VERSION		1
+#define TRC_REC_SIZE	16
+
+/*--------------------------------------+
+|   TYPDEFS                             |
++--------------------------------------*/
+typedef unsigned int	u32;
+typedef unsigned short	u16;
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+static int G_swap;		/**< file has other byte order */
+
+static const char *G_idName[] = {
+	"?", "IRQ", "PROCESS", "STATUS", "QFULL",
+	"POSCNT", "SIGNAL", "GESTURE", "GETSTATUS", "QMERGE",
+	"RESET", "IRQARM", "QGROW"
+};
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static u32 Get32( const unsigned char *p );
+static u16 Get16( const unsigned char *p );
+
+/********************************* main ************************************/
+/** Program main function
+ *
+ *  \param argc       \IN  argument counter
+ *  \param argv       \IN  argument vector
+ *
+ *  \return           success (0) or error (1)
+ */
+int main( int argc, char *argv[] )
+{
+	FILE			*fp;
+	unsigned char	buf[TRC_REC_SIZE];
+	u32				tickRate, ts, ts0 = 0, a, b;
+	u16				id, seq, nextSeq = 0;
+	unsigned long	recs = 0, lost = 0;
+	double			t;
+
+	if (argc != 2 || strcmp(argv[1],"-?")==0) {
+		printf("Syntax: z73_trcdec <file>\n");
+		printf("Function: decode Z73 trace file written by z73_trace\n");
+		return(1);
+	}
+
+	if ((fp = fopen(argv[1], "rb")) == NULL) {
+		perror(argv[1]);
+		return(1);
+	}
+
+	/* header: magic, version, tickRate, recSize */
+	if (fread(buf, 16, 1, fp) != 1) {
+		fprintf(stderr, "*** %s: no header\n", argv[1]);
+		fclose(fp);
+		return(1);
+	}
+
+	G_swap = 0;
+	if (Get32(buf) != TRC_MAGIC) {
+		G_swap = 1;
+		if (Get32(buf) != TRC_MAGIC) {
+			fprintf(stderr, "*** %s: not a Z73 trace file\n", argv[1]);
+			fclose(fp);
+			return(1);
+		}
+	}
+	if (Get32(buf+4) != TRC_VERSION || Get32(buf+12) != TRC_REC_SIZE) {
+		fprintf(stderr, "*** %s: unsupported version %u / record size %u\n",
+				argv[1], Get32(buf+4), Get32(buf+12));
+		fclose(fp);
+		return(1);
+	}
+	tickRate = Get32(buf+8);
+
+	printf("%-8s %-12s %-10s %-10s %-10s\n",
+		   "seq", tickRate ? "time [ms]" : "ticks", "id", "a", "b");
+
+	while (fread(buf, TRC_REC_SIZE, 1, fp) == 1) {
+		ts  = Get32(buf);
+		id  = Get16(buf+4);
+		seq = Get16(buf+6);
+		a   = Get32(buf+8);
+		b   = Get32(buf+12);
+
+		if (recs == 0)
+			ts0 = ts;
+		else if (seq != nextSeq) {
+			printf("--- %u record(s) lost\n", (u16)(seq - nextSeq));
+			lost += (u16)(seq - nextSeq);
+		}
+		nextSeq = seq + 1;
+		recs++;
+
+		printf("%-8u ", seq);
+		if (tickRate) {
+			t = (double)(u32)(ts - ts0) * 1000.0 / tickRate;
+			printf("%-12.3f ", t);
+		}
+		else
+			printf("%-12u ", ts - ts0);
+
+		if (id < sizeof(G_idName)/sizeof(G_idName[0]))
+			printf("%-10s ", G_idName[id]);
+		else
+			printf("0x%-8x ", id);
+
+		printf("0x%08x 0x%08x\n", a, b);
+	}
+
+	printf("%lu records, %lu lost\n", recs, lost);
+	fclose(fp);
+	return(0);
+}
+
+/********************************* Get32 ***********************************/
+/** Read 32 bit value in file byte order
+ *
+ *  \param p          \IN  data
+ *
+ *  \return           value
+ */
+static u32 Get32( const unsigned char *p )
+{
+	u32 v;
+
+	memcpy(&v, p, 4);
+	if (G_swap)
+		v = (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+	return(v);
+}
+
+/********************************* Get16 ***********************************/
+/** Read 16 bit value in file byte order
+ *
+ *  \param p          \IN  data
+ *
+ *  \return           value
+ */
+static u16 Get16( const unsigned char *p )
+{
+	u16 v;
+
+	memcpy(&v, p, 2);
+	if (G_swap)
+		v = (u16)((v >> 8) | (v << 8));
+	return(v);
+}
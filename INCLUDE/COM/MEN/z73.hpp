@@ -0,0 +1,606 @@
+/***********************  I n c l u d e  -  F i l e  ***********************/
+/*!
+ *        \file  z73.hpp
+ *
+ *      \author  Christian.Schuster@men.de
+ *
+ *       \brief  C++ client library for the Z73 driver (header only)
+ *
+ *               - z73::Device: RAII path, typed events, batched reads
+ *               - z73::Event: decoded Z073_STATUS entry with tick and
+ *                 sequence number
+ *               - z73::Reader: background thread draining the device
+ *                 into a lock-free single producer/single consumer queue,
+ *                 consumed by tryPop()/pop(), a callback or (C++20)
+ *                 co_await reader.next()
+ *
+ *               Requires C++17 and the MDIS user libraries mdis_api and
+ *               usr_oss. The coroutine interface is available when the
+ *               compiler supports coroutines (__cpp_impl_coroutine).
+ *               Z73_POSCNT_24 must be set as for the driver.
+ *
+ *    \switches  Z73_POSCNT_24
+ *
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+ /*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _Z73_HPP
+#define _Z73_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+# if __has_include(<coroutine>)
+#  include <coroutine>
+#  define Z73_HAVE_COROUTINE 1
+# endif
+#endif
+
+#include <MEN/men_typs.h>
+#include <MEN/usr_oss.h>
+#include <MEN/mdis_api.h>
+#include <MEN/mdis_err.h>
+#include <MEN/z73_drv.h>
+
+namespace z73 {
+
+/*-----------------------------------------+
+|  Error                                   |
++-----------------------------------------*/
+/** MDIS error, thrown by all functions which can fail */
+class Error : public std::runtime_error
+{
+public:
+    Error( const std::string &what, int32 code )
+        : std::runtime_error( what + ": " + M_errstring( code ) ),
+          code_( code ) {}
+
+    /** MDIS error code */
+    int32 code() const noexcept { return code_; }
+
+private:
+    int32 code_;
+};
+
+/*-----------------------------------------+
+|  Event                                   |
++-----------------------------------------*/
+/** decoded status entry */
+struct Event
+{
+    /** main cause, for switch statements */
+    enum class Kind { Move, Press, Release, Gesture };
+
+    u_int32 status = 0;     /**< raw Z073_STATUS word */
+    u_int32 tick = 0;       /**< time of (last) event [OSS ticks] */
+    u_int32 seq = 0;        /**< sequence number, order of occurrence */
+
+    Event() = default;
+    explicit Event( const Z73_EVENT &ev )
+        : status( ev.status ), tick( ev.tick ), seq( ev.seq ) {}
+
+    Kind kind() const noexcept
+    {
+        if( status & Z073_STATUS_GEST ) return Kind::Gesture;
+        if( status & Z073_STATUS_PRS )  return Kind::Press;
+        if( status & Z073_STATUS_REL )  return Kind::Release;
+        return Kind::Move;
+    }
+
+    bool moved() const noexcept    { return (status & Z073_STATUS_MOV) != 0; }
+    bool pressed() const noexcept  { return (status & Z073_STATUS_PRS) != 0; }
+    bool released() const noexcept { return (status & Z073_STATUS_REL) != 0; }
+
+    /** gesture code (Z073_GEST_xxx), 0 if no gesture */
+    u_int32 gesture() const noexcept
+    {
+        return (status & Z073_STATUS_GEST) ?
+            (status & Z073_STATUS_GEST_CODE) : 0;
+    }
+
+    /** signed count delta of a movement entry */
+    int32 count() const noexcept
+    {
+        const u_int32 sign = (Z073_STATUS_CNT >> 1) + 1;
+
+        if( !moved() || gesture() )
+            return 0;
+        return (int32)(((status & Z073_STATUS_CNT) ^ sign) - sign);
+    }
+
+    /** input levels when the entry was created */
+    bool buttonDown() const noexcept
+        { return (status & Z073_STATUS_PRESS_N) != 0; }
+    bool inputA() const noexcept { return (status & Z073_STATUS_INPUT_A) != 0; }
+    bool inputB() const noexcept { return (status & Z073_STATUS_INPUT_B) != 0; }
+};
+
+/*-----------------------------------------+
+|  Device                                  |
++-----------------------------------------*/
+/** RAII MDIS path to a Z73 device
+ *
+ *  Move only. The path is closed by the destructor.
+ */
+class Device
+{
+public:
+    explicit Device( const std::string &name )
+    {
+        if( (path_ = M_open( name.c_str() )) < 0 )
+            throw Error( "open " + name, (int32)UOS_ErrnoGet() );
+    }
+
+    ~Device() { close(); }
+
+    Device( Device &&o ) noexcept
+        : path_( std::exchange( o.path_, -1 ) ) {}
+
+    Device &operator=( Device &&o ) noexcept
+    {
+        if( this != &o ) {
+            close();
+            path_ = std::exchange( o.path_, -1 );
+        }
+        return *this;
+    }
+
+    Device( const Device & ) = delete;
+    Device &operator=( const Device & ) = delete;
+
+    MDIS_PATH path() const noexcept { return path_; }
+
+    void close() noexcept
+    {
+        if( path_ >= 0 ) {
+            M_close( path_ );
+            path_ = -1;
+        }
+    }
+
+    void setstat( int32 code, INT32_OR_64 value )
+    {
+        if( M_setstat( path_, code, value ) < 0 )
+            throw Error( "setstat", (int32)UOS_ErrnoGet() );
+    }
+
+    int32 getstat( int32 code )
+    {
+        int32 value = 0;
+
+        if( M_getstat( path_, code, &value ) < 0 )
+            throw Error( "getstat", (int32)UOS_ErrnoGet() );
+        return value;
+    }
+
+    /** block getstat, returns the size filled in by the driver */
+    int32 getblock( int32 code, void *data, int32 size )
+    {
+        M_SG_BLOCK blk;
+
+        blk.size = size;
+        blk.data = data;
+        if( M_getstat( path_, code, (int32*)&blk ) < 0 )
+            throw Error( "getstat", (int32)UOS_ErrnoGet() );
+        return blk.size;
+    }
+
+    /** enable/disable the device interrupt */
+    void enable( bool on ) { setstat( M_MK_IRQ_ENABLE, on ? 1 : 0 ); }
+
+    /** read up to \a max events with one call (Z073_BLK_EVENTS)
+     *
+     *  Returns 0 if the queue is empty. Button entries the driver had to
+     *  drop are counted in overruns().
+     */
+    std::size_t read( Event *ev, std::size_t max )
+    {
+        Z73_EVENT raw[64];
+        std::size_t n = 0, got;
+        M_SG_BLOCK blk;
+
+        while( n < max ) {
+            got = max - n < 64 ? max - n : 64;
+            blk.size = (int32)(got * sizeof(Z73_EVENT));
+            blk.data = raw;
+
+            if( M_getstat( path_, Z073_BLK_EVENTS, (int32*)&blk ) < 0 ) {
+                int32 err = (int32)UOS_ErrnoGet();
+
+                if( err == Z073_ERR_NO_STATUS )
+                    break;
+                throw Error( "read events", err );
+            }
+
+            got = (std::size_t)blk.size / sizeof(Z73_EVENT);
+            for( std::size_t i = 0; i < got; i++ )
+                ev[n++] = Event( raw[i] );
+            if( got < 64 )
+                break;
+        }
+        return n;
+    }
+
+    template<std::size_t N>
+    std::size_t read( Event (&ev)[N] ) { return read( ev, N ); }
+
+    std::size_t read( std::vector<Event> &ev )
+        { return read( ev.data(), ev.size() ); }
+
+    /** wait until events are available (Z073_BLK_WAIT)
+     *
+     *  The timeout is passed with the call, Z073_WAIT_TOUT of the device
+     *  is not used.
+     *
+     *  \param msec    timeout [ms], -1 = forever
+     *  \return        false on timeout
+     */
+    bool wait( int32 msec = -1 )
+    {
+        Z73_WAIT w = {};
+        M_SG_BLOCK blk;
+
+        w.tout   = msec;
+        blk.size = sizeof(w);
+        blk.data = &w;
+        if( M_getstat( path_, Z073_BLK_WAIT, (int32*)&blk ) < 0 ) {
+            int32 err = (int32)UOS_ErrnoGet();
+
+            if( err == ERR_OSS_TIMEOUT )
+                return false;
+            throw Error( "wait", err );
+        }
+        return true;
+    }
+
+    /** accumulated position */
+    int32 position()
+    {
+        int32 value;
+
+        setstat( M_MK_CH_CURRENT, Z073_CH_POS );
+        if( M_read( path_, &value ) < 0 )
+            throw Error( "read position", (int32)UOS_ErrnoGet() );
+        return value;
+    }
+
+    /** position now (Z073_BLK_POS_EXTRAP) */
+    Z73_POS_EXTRAP extrapolate()
+    {
+        Z73_POS_EXTRAP px = {};
+
+        px.mode = Z073_EXTRAP_NOW;
+        getblock( Z073_BLK_POS_EXTRAP, &px, sizeof(px) );
+        return px;
+    }
+
+    /** position at \a target, same time base as Z73_POS_EXTRAP.now */
+    Z73_POS_EXTRAP extrapolate( u_int32 target )
+    {
+        Z73_POS_EXTRAP px = {};
+
+        px.mode   = Z073_EXTRAP_AT;
+        px.target = target;
+        getblock( Z073_BLK_POS_EXTRAP, &px, sizeof(px) );
+        return px;
+    }
+
+    /** read up to \a max completed interval summaries, oldest first
+     *  (Z073_BLK_SUMMARY, enabled with Z073_SUM_INTERVAL)
+     */
+    std::size_t summaries( Z73_SUMMARY *sum, std::size_t max )
+    {
+        return (std::size_t)getblock( Z073_BLK_SUMMARY, sum,
+                                      (int32)(max * sizeof(Z73_SUMMARY)) ) /
+               sizeof(Z73_SUMMARY);
+    }
+
+    /** button entries dropped by the driver, queue was full
+     *  (Z073_BTNQ_DROPPED) */
+    u_int32 overruns() { return (u_int32)getstat( Z073_BTNQ_DROPPED ); }
+
+private:
+    MDIS_PATH path_ = -1;
+};
+
+/*-----------------------------------------+
+|  SpscQueue                               |
++-----------------------------------------*/
+/** bounded lock-free single producer/single consumer queue
+ *
+ *  The capacity is rounded up to a power of two.
+ */
+template<typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue( std::size_t capacity )
+    {
+        std::size_t n = 2;
+
+        while( n < capacity )
+            n <<= 1;
+        buf_.resize( n );
+        mask_ = n - 1;
+    }
+
+    SpscQueue( const SpscQueue & ) = delete;
+    SpscQueue &operator=( const SpscQueue & ) = delete;
+
+    /** producer: false if full */
+    bool push( const T &v )
+    {
+        const std::size_t tail = tail_.load( std::memory_order_relaxed );
+
+        if( tail - headCache_ > mask_ ) {
+            headCache_ = head_.load( std::memory_order_acquire );
+            if( tail - headCache_ > mask_ )
+                return false;
+        }
+        buf_[tail & mask_] = v;
+        tail_.store( tail + 1, std::memory_order_release );
+        return true;
+    }
+
+    /** consumer: false if empty */
+    bool pop( T &v )
+    {
+        const std::size_t head = head_.load( std::memory_order_relaxed );
+
+        if( head == tailCache_ ) {
+            tailCache_ = tail_.load( std::memory_order_acquire );
+            if( head == tailCache_ )
+                return false;
+        }
+        v = buf_[head & mask_];
+        head_.store( head + 1, std::memory_order_release );
+        return true;
+    }
+
+    bool empty() const
+    {
+        return head_.load( std::memory_order_acquire ) ==
+               tail_.load( std::memory_order_acquire );
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+private:
+    std::vector<T> buf_;
+    std::size_t mask_ = 0;
+    alignas(64) std::atomic<std::size_t> head_{ 0 };  /* consumer */
+    std::size_t tailCache_ = 0;                        /* consumer */
+    alignas(64) std::atomic<std::size_t> tail_{ 0 };  /* producer */
+    std::size_t headCache_ = 0;                        /* producer */
+};
+
+/*-----------------------------------------+
+|  Reader                                  |
++-----------------------------------------*/
+/** background reader for a Device
+ *
+ *  The reader thread waits with Z073_BLK_WAIT and drains the device with
+ *  batched Z073_BLK_EVENTS reads. In queue mode the events are pushed to
+ *  a lock-free queue and consumed by one thread with tryPop(), pop() or
+ *  co_await next(). In callback mode the callback is called in the reader
+ *  thread instead. Events which don't fit into the queue are counted in
+ *  dropped(). Each wait is limited to pollMs (negative values are taken
+ *  as the default), which bounds the time stop() waits for the thread.
+ *  An error or an exception thrown by the callback stops the reader, see
+ *  error() and exception().
+ *
+ *  The Device must outlive the Reader.
+ */
+class Reader
+{
+public:
+    using Callback = std::function<void( const Event & )>;
+
+    /** queue mode */
+    explicit Reader( Device &dev, std::size_t capacity = 1024,
+                     int32 pollMs = 100 )
+        : dev_( dev ), queue_( capacity ),
+          pollMs_( pollMs < 0 ? 100 : pollMs )
+    {
+        thread_ = std::thread( &Reader::run, this );
+    }
+
+    /** callback mode */
+    Reader( Device &dev, Callback cb, int32 pollMs = 100 )
+        : dev_( dev ), queue_( 2 ), cb_( std::move( cb ) ),
+          pollMs_( pollMs < 0 ? 100 : pollMs )
+    {
+        thread_ = std::thread( &Reader::run, this );
+    }
+
+    ~Reader() { stop(); }
+
+    Reader( const Reader & ) = delete;
+    Reader &operator=( const Reader & ) = delete;
+
+    /** stop the reader thread, wakes all waiting consumers */
+    void stop()
+    {
+        stop_.store( true );
+        if( thread_.joinable() )
+            thread_.join();
+        wake();
+    }
+
+    bool running() const noexcept { return !done_.load(); }
+
+    /** consumer: get an event without blocking */
+    bool tryPop( Event &ev ) { return queue_.pop( ev ); }
+
+    /** consumer: wait up to \a timeout for an event
+     *
+     *  \return false on timeout or if the reader stopped
+     */
+    template<class Rep, class Period>
+    bool pop( Event &ev, std::chrono::duration<Rep, Period> timeout )
+    {
+        if( queue_.pop( ev ) )
+            return true;
+
+        std::unique_lock<std::mutex> lock( mtx_ );
+        sleepers_.fetch_add( 1 );
+        cv_.wait_for( lock, timeout, [this] {
+            return !queue_.empty() || done_.load(); } );
+        sleepers_.fetch_sub( 1 );
+        return queue_.pop( ev );
+    }
+
+    /** events lost because the queue was full */
+    std::uint64_t dropped() const noexcept { return dropped_.load(); }
+
+    /** MDIS error which stopped the reader thread, 0 if none */
+    int32 error() const noexcept { return error_.load(); }
+
+    /** exception which stopped the reader thread (z73::Error or thrown by
+     *  the callback), null if none. Valid when running() is false.
+     */
+    std::exception_ptr exception() const
+    {
+        return done_.load() ? exc_ : nullptr;
+    }
+
+#ifdef Z73_HAVE_COROUTINE
+    /** awaitable for the next event, see next() */
+    class NextAwaiter
+    {
+    public:
+        explicit NextAwaiter( Reader &r ) : r_( r ) {}
+
+        bool await_ready() { return !r_.queue_.empty() || r_.done_.load(); }
+
+        bool await_suspend( std::coroutine_handle<> h )
+        {
+            Reader &r = r_;     /* the frame may be resumed after store */
+
+            r.waiter_.store( h.address() );
+            if( r.queue_.empty() && !r.done_.load() )
+                return true;
+            /* raced with the producer: resume now unless it already did */
+            return r.waiter_.exchange( nullptr ) == nullptr;
+        }
+
+        std::optional<Event> await_resume()
+        {
+            Event ev;
+
+            if( r_.queue_.pop( ev ) )
+                return ev;
+            return std::nullopt;
+        }
+
+    private:
+        Reader &r_;
+    };
+
+    /** co_await reader.next() yields the next event or std::nullopt when
+     *  the reader stopped. The coroutine is resumed in the reader thread
+     *  (or in the thread calling stop()). One awaiting coroutine at most.
+     */
+    NextAwaiter next() { return NextAwaiter( *this ); }
+#endif
+
+private:
+    void run()
+    {
+        std::vector<Event> buf( 64 );
+        std::size_t n, i;
+
+        try {
+            while( !stop_.load() ) {
+                if( !dev_.wait( pollMs_ ) )
+                    continue;
+
+                while( (n = dev_.read( buf )) > 0 ) {
+                    for( i = 0; i < n; i++ ) {
+                        if( cb_ )
+                            cb_( buf[i] );
+                        else if( !queue_.push( buf[i] ) )
+                            dropped_++;
+                    }
+                    wake();
+                    if( n < buf.size() )
+                        break;
+                }
+            }
+        }
+        catch( const Error &e ) {
+            error_.store( e.code() );
+            exc_ = std::current_exception();
+        }
+        catch( ... ) {
+            exc_ = std::current_exception();
+        }
+        done_.store( true );
+        wake();     /* consumers waiting for an event see the end */
+    }
+
+    /** wake a consumer blocked in pop() or co_await next() */
+    void wake()
+    {
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if( sleepers_.load() ) {
+            std::lock_guard<std::mutex> lock( mtx_ );
+            cv_.notify_all();
+        }
+#ifdef Z73_HAVE_COROUTINE
+        if( void *h = waiter_.exchange( nullptr ) )
+            std::coroutine_handle<>::from_address( h ).resume();
+#endif
+    }
+
+    Device &dev_;
+    SpscQueue<Event> queue_;
+    Callback cb_;
+    int32 pollMs_;
+    std::thread thread_;
+    std::atomic<bool> stop_{ false };
+    std::atomic<bool> done_{ false };
+    std::atomic<int32> error_{ 0 };
+    std::exception_ptr exc_;        /* written before done_ */
+    std::atomic<std::uint64_t> dropped_{ 0 };
+    std::atomic<u_int32> sleepers_{ 0 };
+    std::mutex mtx_;
+    std::condition_variable cv_;
+#ifdef Z73_HAVE_COROUTINE
+    std::atomic<void*> waiter_{ nullptr };
+#endif
+};
+
+} /* namespace z73 */
+
+#endif /* _Z73_HPP */
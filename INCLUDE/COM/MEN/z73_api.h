@@ -0,0 +1,71 @@
+/***********************  I n c l u d e  -  F i l e  ***********************/
+/*!
+ *        \file  z73_api.h
+ *
+ *      \author  Christian.Schuster@men.de
+ *
+ *       \brief  Header file for the Z73 user library
+ *
+ *    \switches  LINUX
+ *
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+ /*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _Z73_API_H
+#define _Z73_API_H
+
+#ifdef __cplusplus
+      extern "C" {
+#endif
+
+/*-----------------------------------------+
+|  DEFINES                                 |
++-----------------------------------------*/
+#define Z73_WAITSET_MAX         32  /**< max. number of paths in a wait set */
+
+/*-----------------------------------------+
+|  TYPEDEFS                                |
++-----------------------------------------*/
+/** wait set for multiple Z73 paths (opaque) */
+typedef struct Z73_WAITSET Z73_WAITSET;
+
+/*-----------------------------------------+
+|  PROTOTYPES                              |
++-----------------------------------------*/
+extern int32 Z73_WaitSetCreate( const MDIS_PATH *paths, const int32 *sigs,
+                                u_int32 num, Z73_WAITSET **wsP );
+extern int32 Z73_WaitSetFd( Z73_WAITSET *ws );
+extern int32 Z73_WaitSetWait( Z73_WAITSET *ws, int32 msec, u_int8 *ready );
+extern int32 Z73_WaitSetDestroy( Z73_WAITSET **wsP );
+
+/* shared memory readers (z73_shmd), see z73_shm.h */
+extern int32 Z73_ShmOpen( const char *name, struct Z73_SHM **shmP );
+extern int32 Z73_ShmClose( struct Z73_SHM **shmP );
+extern int32 Z73_ShmState( const struct Z73_SHM *shm, u_int32 dev,
+                           struct Z73_SHM_STATE *st );
+extern int32 Z73_ShmEvents( const struct Z73_SHM *shm, u_int32 dev,
+                            u_int32 *nextP, struct Z73_EVENT *ev,
+                            u_int32 max, u_int32 *lostP );
+
+#ifdef __cplusplus
+      }
+#endif
+
+#endif /* _Z73_API_H */
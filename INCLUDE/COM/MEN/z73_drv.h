@@ -63,6 +63,186 @@
                  (button pressed/released, count moved up/down). */
         /*!< This is usually called from application after a signal is
              received. */
+#define Z073_SIG_GESTURE        (M_DEV_OF+0x07)
+        /**<  S:  set signal to trigger when a gesture was detected */
+#define Z073_SIG_MODE           (M_DEV_OF+0x08)
+        /**< G/S: signal notification mode (Z073_SIGMODE_xxx) */
+#define Z073_SIG_WATERMARK      (M_DEV_OF+0x09)
+        /**< G/S: status queue fill to reach before signalling
+                  (Z073_SIGMODE_WATERMARK) */
+#define Z073_SIG_MAXLAT         (M_DEV_OF+0x0A)
+        /**< G/S: max. latency [ms] of a held back signal, 0=unlimited */
+#define Z073_WAIT               (M_DEV_OF+0x0B)
+        /**<  G:  wait until device is ready (status available), returns
+                  number of queued entries */
+#define Z073_WAIT_TOUT          (M_DEV_OF+0x0C)
+        /**< G/S: timeout [ms] for Z073_WAIT, -1=forever (default).
+                  Shared by all paths of the device, prefer Z073_BLK_WAIT */
+#define Z073_SIG_READY          (M_DEV_OF+0x0D)
+        /**<  S:  set signal to trigger when device becomes ready
+                  (edge triggered, re-armed when queue was read empty) */
+#define Z073_SIG_EVENT          (M_DEV_OF+0x0E)
+        /**<  S:  set first of Z073_EVTSIG_NUM event signals, 0=remove */
+        /*!< One signal per event, the signal number encodes the event
+             (see \ref event_signals "event signals"). */
+#define Z073_SIG_EVENT_NOQ      (M_DEV_OF+0x0F)
+        /**< G/S: don't queue press/release/gesture entries which were
+                  delivered by event signals */
+#define Z073_QORDER             (M_DEV_OF+0x10)
+        /**< G/S: read order of the status queues (Z073_QORDER_xxx) */
+#define Z073_STATUSQ_SIZE       (M_DEV_OF+0x11)
+        /**< G/S: depth of movement queue (2..65536), resized live. G
+                  returns the current depth, which differs in adaptive
+                  mode */
+#define Z073_BTNQ_SIZE          (M_DEV_OF+0x12)
+        /**< G/S: depth of button queue (2..65536), resized live */
+#define Z073_STATUSQ_MAX        (M_DEV_OF+0x13)
+        /**< G/S: max. depth of adaptive movement queue (..65536),
+                  0=not adaptive */
+#define Z073_STATUSQ_QUIET      (M_DEV_OF+0x14)
+        /**< G/S: quiet time [ms] before an adaptive movement queue
+                  shrinks back to Z073_STATUSQ_SIZE */
+#define Z073_CAPTURE            (M_DEV_OF+0x15)
+        /**< G/S: raw edge capture, number of records in capture ring
+                  (2..65536), 0=off (default). Setting it clears the
+                  ring. */
+#define Z073_RESET              (M_DEV_OF+0x16)
+        /**<  S:  reset without close/open, value = Z073_RESET_xxx flags.
+                  Clears pending interrupts and the error state and
+                  enables the configured interrupts. Unknown flags give
+                  ERR_LL_ILL_PARAM. */
+#define Z073_WARM_STATE         (M_DEV_OF+0x18)
+        /**<  G:  result of the warm start (Z073_WARM_xxx), see
+                  descriptor key Z073_WARM_START */
+#define Z073_SUM_INTERVAL       (M_DEV_OF+0x19)
+        /**< G/S: summary interval [ms], 0=off (default). Setting it
+                  clears the summaries, see Z73_SUMMARY. */
+#define Z073_IRQ_DEMAND         (M_DEV_OF+0x1a)
+        /**< G/S: demand driven interrupts, max. unread entries while
+                  nobody waits or has a signal installed, 0=interrupts
+                  always enabled (default) */
+#define Z073_WDOG               (M_DEV_OF+0x1b)
+        /**< G/S: wrap protection watchdog, max. period [ms], 0=off
+                  (default), see descriptor key Z073_WDOG_MIN */
+#define Z073_WDOG_PERIOD        (M_DEV_OF+0x1c)
+        /**<  G:  current period of the watchdog [ms], 0=off */
+#define Z073_BTNQ_DROPPED       (M_DEV_OF+0x1d)
+        /**<  G:  button entries dropped because the button queue was
+                  full (free running) */
+#define Z073_TS_RATE            (M_DEV_OF+0x1e)
+        /**<  G:  rate [Hz] of the timestamps in trace, capture, register
+                  log and position records, 0=unknown */
+/**@}*/
+
+/** \name Status queue read order
+ *  \anchor queue_order
+ *
+ *  Press/release/gesture entries and movement entries are kept in
+ *  separate queues. The order selects how Z073_STATUS and Z073_BLK_EVENTS
+ *  read them.
+ */
+/**@{*/
+#define Z073_QORDER_SEQ         0   /**< order of occurrence (default) */
+#define Z073_QORDER_PRIO        1   /**< button queue first */
+/**@}*/
+
+/** \name Event signals
+ *  \anchor event_signals
+ *
+ *  Offset of the signal sent for an event to the base signal set with
+ *  Z073_SIG_EVENT.
+ */
+/**@{*/
+#define Z073_EVTSIG_PRS         0   /**< push button pressed           */
+#define Z073_EVTSIG_REL         1   /**< push button released          */
+#define Z073_EVTSIG_UP          2   /**< moved up                      */
+#define Z073_EVTSIG_DWN         3   /**< moved down                    */
+#define Z073_EVTSIG_GEST        4   /**< gesture, add gesture code - 1 */
+#define Z073_EVTSIG_NUM         9   /**< number of event signals used  */
+/**@}*/
+
+/** \name Signal notification modes
+ *  \anchor sig_modes
+ */
+/**@{*/
+#define Z073_SIGMODE_EVERY      0   /**< signal on every event (default) */
+#define Z073_SIGMODE_EDGE       1   /**< one signal until queue was read */
+#define Z073_SIGMODE_WATERMARK  2   /**< signal when watermark is reached,
+                                         then as Z073_SIGMODE_EDGE */
+/**@}*/
+
+/** \name Z73 channels for M_read()
+ *  \anchor read_channels
+ *
+ *  All channels are read-only and do not disturb the status queue.
+ */
+/**@{*/
+#define Z073_CH_POS             0   /**< accumulated position            */
+#define Z073_CH_INPUTS          1   /**< current input levels, coded as
+                                         Z073_STATUS_PRESS_N/INPUT_A/B   */
+#define Z073_CH_QFILL           2   /**< number of queued status entries */
+/**@}*/
+
+/** \name Z73 specific Getstat/Setstat block codes */
+/**@{*/
+#define Z073_BLK_TRACE          (M_DEV_BLK_OF+0x00)
+        /**<  G:  read (and remove) trace records, see Z73_TRC_REC.
+                  Only available if driver built with Z73_TRACE. */
+#define Z073_BLK_EVENTS         (M_DEV_BLK_OF+0x01)
+        /**<  G:  read (and remove) several status entries, see Z73_EVENT */
+#define Z073_BLK_CAPTURE        (M_DEV_BLK_OF+0x02)
+        /**<  G:  read (and remove) capture records, see Z73_CAP_REC */
+#define Z073_BLK_POS_EXTRAP     (M_DEV_BLK_OF+0x03)
+        /**<  G:  position extrapolated to a target time, see
+                  Z73_POS_EXTRAP. The block is passed in both directions. */
+#define Z073_BLK_RESET          (M_DEV_BLK_OF+0x04)
+        /**<  S:  as Z073_RESET with position preset, see Z73_RESET */
+#define Z073_BLK_MMIO           (M_DEV_BLK_OF+0x05)
+        /**<  G:  read (and remove) register access records, see
+                  Z73_MMIO_REC. Only available if driver built with
+                  Z73_MMIO_LOG. */
+#define Z073_BLK_CHECKPOINT     (M_DEV_BLK_OF+0x07)
+        /**< G/S: position checkpoint, see Z73_CHECKPOINT. Set restores a
+                  checkpoint taken before the driver was loaded. */
+#define Z073_BLK_SUMMARY        (M_DEV_BLK_OF+0x08)
+        /**<  G:  read (and remove) completed summaries, see Z73_SUMMARY */
+#define Z073_BLK_WAIT           (M_DEV_BLK_OF+0x09)
+        /**<  G:  as Z073_WAIT with the timeout passed in the call, see
+                  Z73_WAIT. The block is passed in both directions. */
+/**@}*/
+
+/** \name Reset flags (Z073_RESET, Z73_RESET.flags) */
+/**@{*/
+#define Z073_RESET_FLUSH        0x01    /**< discard queued entries, else
+                                             they are kept            */
+#define Z073_RESET_POS          0x02    /**< set position to 0 (or to
+                                             Z73_RESET.pos)           */
+/**@}*/
+
+/** \name Warm start result (Z073_WARM_STATE) */
+/**@{*/
+#define Z073_WARM_COLD          0       /**< no checkpoint, position 0   */
+#define Z073_WARM_RESTORED      1       /**< position restored           */
+#define Z073_WARM_MISMATCH      2       /**< checkpoint rejected, inputs
+                                             don't match the counts      */
+/**@}*/
+
+/** \name Position extrapolation (Z73_POS_EXTRAP)
+ *  \anchor pos_extrap
+ */
+/**@{*/
+#define Z073_EXTRAP_AT          0       /**< mode: target time given  */
+#define Z073_EXTRAP_NOW         1       /**< mode: target is now      */
+
+#define Z073_EXTRAP_STILL       0x01    /**< encoder stationary, vel=0 */
+#define Z073_EXTRAP_PREDICT     0x02    /**< target in the future,
+                                             velocity model used       */
+#define Z073_EXTRAP_CLAMPED     0x04    /**< horizon limited to the
+                                             sample window             */
+#define Z073_EXTRAP_PAST        0x08    /**< target before oldest sample,
+                                             oldest position returned  */
+
+#define Z073_EXTRAP_CONF_MAX    100     /**< max. confidence value     */
 /**@}*/
 
 /** \name Z073_STATUS word returned
@@ -74,6 +254,7 @@
 #define Z073_STATUS_INPUT_A     0x10000000  /**< current: input B       */
 #define Z073_STATUS_REL         0x08000000  /**< push button released   */
 #define Z073_STATUS_PRS         0x04000000  /**< push button pressed    */
+#define Z073_STATUS_GEST        0x02000000  /**< gesture detected       */
 #define Z073_STATUS_MOV         0x01000000  /**< position changed       */
 #ifdef Z73_POSCNT_24
  #define Z073_STATUS_CNT        0x00FFFFFF  /**< current position       */
@@ -82,16 +263,203 @@
 #endif
 /**@}*/
 
+/** \name Gesture codes
+ *  \anchor gesture_codes
+ *
+ *  Returned in the lower bits of the Z073_STATUS word
+ *  (Z073_STATUS_GEST_CODE) when Z073_STATUS_GEST is set.
+ */
+/**@{*/
+#define Z073_STATUS_GEST_CODE   0x000000FF  /**< gesture code mask      */
+#define Z073_GEST_CLICK         0x01        /**< single click           */
+#define Z073_GEST_DBLCLICK      0x02        /**< double click           */
+#define Z073_GEST_LONG_START    0x03        /**< long press started     */
+#define Z073_GEST_LONG_END      0x04        /**< long press ended       */
+#define Z073_GEST_REPEAT        0x05        /**< auto repeat during long press */
+/**@}*/
+
 /** \name Z073 specific Error/Warning codes */
 /**@{*/
 #define Z073_ERR_NO_STATUS          (ERR_DEV+1) /**< No status change from HW */
-#define Z073_ERR_STATUSQ_FULL       (ERR_DEV+2) /**< Status queue full */
+#define Z073_ERR_STATUSQ_FULL       (ERR_DEV+2) /**< Button queue full, no
+                                                   longer returned: entries
+                                                   are dropped and counted
+                                                   (Z073_BTNQ_DROPPED) */
+#define Z073_ERR_CKPT_MISMATCH      (ERR_DEV+3) /**< Checkpoint rejected */
+/**@}*/
+
+/** \name Trace record ids (Z73_TRC_REC.id)
+ *  \anchor trace_ids
+ */
+/**@{*/
+#define Z073_TRC_IRQ            0x01    /**< ISR: a=Z073_IRQ, b=irqEn      */
+#define Z073_TRC_PROCESS        0x02    /**< deferred: a=Z073_IRQ snapshot */
+#define Z073_TRC_STATUS         0x03    /**< queued: a=status, b=fill      */
+#define Z073_TRC_QFULL          0x04    /**< queue full: a=status lost     */
+#define Z073_TRC_POSCNT         0x05    /**< a=Z073_POS_CNT, b=position    */
+#define Z073_TRC_SIGNAL         0x06    /**< a=signals sent (flags)        */
+#define Z073_TRC_GESTURE        0x07    /**< a=gesture code, b=state       */
+#define Z073_TRC_GETSTATUS      0x08    /**< a=status/error, b=fill        */
+#define Z073_TRC_QMERGE         0x09    /**< movement coalesced: a=status  */
+#define Z073_TRC_RESET          0x0A    /**< reset: a=flags, b=position    */
+#define Z073_TRC_IRQARM         0x0B    /**< a=causes enabled, b=fill      */
+#define Z073_TRC_QGROW          0x0C    /**< movement queue grown by the
+                                             producer: a=depth, b=fill     */
+/**@}*/
+
+/** \name Register access record types (Z73_MMIO_REC.type)
+ *  \anchor mmio_types
+ */
+/**@{*/
+#define Z073_MMIO_START         0x01    /**< log started: a=tick rate      */
+#define Z073_MMIO_RD            0x02    /**< read: a=offset, b=value       */
+#define Z073_MMIO_WR            0x03    /**< write: a=offset, b=value      */
+#define Z073_MMIO_IRQ           0x04    /**< ISR entered                   */
+#define Z073_MMIO_ALARM         0x05    /**< alarm: a=Z073_MMIO_ALM_xxx    */
+#define Z073_MMIO_GETSTAT       0x06    /**< a=code, b=block size or 0     */
+#define Z073_MMIO_SETSTAT       0x07    /**< a=code, b=value or block size */
+#define Z073_MMIO_READ          0x08    /**< M_read: a=channel             */
+#define Z073_MMIO_DATA          0x09    /**< block data of the preceding
+                                             Get/SetStat: a=byte offset,
+                                             b=data word                   */
+#define Z073_MMIO_LOST          0x0A    /**< log full: a=records lost      */
+
+#define Z073_MMIO_ALM_DEFER     1       /**< deferred irq processing       */
+#define Z073_MMIO_ALM_GESTURE   2       /**< gesture timing                */
+#define Z073_MMIO_ALM_SIGLAT    3       /**< signal latency                */
+#define Z073_MMIO_ALM_WDOG      4       /**< wrap protection watchdog      */
+#define Z073_MMIO_ALM_QGROW     5       /**< movement queue grow           */
+#define Z073_MMIO_DATA_MAX      16      /**< block bytes logged per call   */
+/**@}*/
+
+/** \name Trace/capture/register log file header
+ *  (written by z73_trace/z73_capture)
+ */
+/**@{*/
+#define Z073_TRC_MAGIC          0x5a373354  /**< "Z73T" */
+#define Z073_TRC_VERSION        1
+#define Z073_CAP_MAGIC          0x5a373343  /**< "Z73C" */
+#define Z073_CAP_VERSION        1
+#define Z073_MMIO_MAGIC         0x5a37334d  /**< "Z73M" */
+#define Z073_CKPT_MAGIC         0x5a37334b  /**< "Z73K" (Z73_CHECKPOINT) */
+#define Z073_CKPT_VERSION       1
+#define Z073_MMIO_VERSION       2
+/**@}*/
+
+/** \name Input levels and pending bits in Z73_CAP_REC.irq
+ *  (raw Z073_IRQ register)
+ *  \anchor cap_irq_bits
+ */
+/**@{*/
+#define Z073_CAP_PRESS_N        0x40    /**< push button level           */
+#define Z073_CAP_A              0x20    /**< input A level               */
+#define Z073_CAP_B              0x10    /**< input B level               */
+#define Z073_CAP_PENDING        0x0F    /**< pending REL/PRS/DWN/UP bits */
 /**@}*/
 
 /*-----------------------------------------+
 |  TYPEDEFS                                |
 +-----------------------------------------*/
-/* ... */
+/** status entry (Z073_BLK_EVENTS) */
+typedef struct Z73_EVENT {
+    u_int32     status;     /**< \ref status_return "Z073_STATUS word" */
+    u_int32     tick;       /**< time of (last) event [OSS ticks] */
+    u_int32     seq;        /**< sequence number, gives the order of
+                                 occurrence across both queues */
+} Z73_EVENT;
+
+/** trace record (Z073_BLK_TRACE) */
+typedef struct Z73_TRC_REC {
+    u_int32     ts;         /**< timestamp [ticks] */
+    u_int16     id;         /**< record id (Z073_TRC_xxx) */
+    u_int16     seq;        /**< sequence number, gaps = records lost */
+    u_int32     a;          /**< first value, depends on id */
+    u_int32     b;          /**< second value, depends on id */
+} Z73_TRC_REC;
+
+/** register access record (Z073_BLK_MMIO) */
+typedef struct Z73_MMIO_REC {
+    u_int32     ts;         /**< timestamp [ticks, see Z73_TIMESTAMP] */
+    u_int16     type;       /**< \ref mmio_types "record type" */
+    u_int16     seq;        /**< sequence number, gaps = records lost */
+    u_int32     a;          /**< first value, depends on type */
+    u_int32     b;          /**< second value, depends on type */
+    u_int32     tid;        /**< task which wrote the record (OSS_GetPid),
+                                 meaningless in ISR and alarm records */
+} Z73_MMIO_REC;
+
+/** capture record (Z073_BLK_CAPTURE), one per interrupt */
+typedef struct Z73_CAP_REC {
+    u_int32     ts;         /**< timestamp [ticks, see Z73_TIMESTAMP] */
+    u_int32     irq;        /**< raw Z073_IRQ register (Z073_CAP_xxx) */
+    int32       delta;      /**< counts read from Z073_POS_CNT */
+    u_int32     seq;        /**< sequence number, gaps = records lost */
+} Z73_CAP_REC;
+
+/** position extrapolation (Z073_BLK_POS_EXTRAP) */
+typedef struct Z73_POS_EXTRAP {
+    u_int32     mode;       /**< in:  Z073_EXTRAP_AT/NOW */
+    u_int32     target;     /**< in:  target time (Z073_EXTRAP_AT) [ticks,
+                                      see Z073_TS_RATE] */
+    u_int32     now;        /**< out: time of the call [ticks] */
+    u_int32     tickRate;   /**< out: ticks per second (Z073_TS_RATE).
+                                      Only the cycle counter timestamp
+                                      (x86, PowerPC) resolves single
+                                      counts; with the system tick the
+                                      velocity is averaged over a tick. */
+    int32       pos;        /**< out: position at target time */
+    int32       posRead;    /**< out: position read at time of call */
+    int32       vel;        /**< out: velocity [counts/tick, 16.16 fixed] */
+    int32       age;        /**< out: target time - last count change */
+    u_int32     conf;       /**< out: confidence, 0..Z073_EXTRAP_CONF_MAX */
+    u_int32     flags;      /**< out: Z073_EXTRAP_STILL/PREDICT/... */
+} Z73_POS_EXTRAP;
+
+/** wait until the device is ready (Z073_BLK_WAIT) */
+typedef struct Z73_WAIT {
+    int32       tout;       /**< in: timeout [ms], -1=forever, 0=don't block */
+    u_int32     fill;       /**< out: number of queued entries */
+} Z73_WAIT;
+
+/** reset with position preset (Z073_BLK_RESET) */
+typedef struct Z73_RESET {
+    u_int32     flags;      /**< Z073_RESET_xxx */
+    int32       pos;        /**< new position if Z073_RESET_POS */
+} Z73_RESET;
+
+/** summary of one interval (Z073_BLK_SUMMARY). Intervals without a
+ *  count change or button event have no summary. */
+typedef struct Z73_SUMMARY {
+    u_int32     start;      /**< begin of the interval [OSS ticks] */
+    u_int32     seq;        /**< sequence number, gaps = summaries lost */
+    int32       pos;        /**< position at the last change */
+    int32       delta;      /**< net counts */
+    int32       posMin;     /**< min. position */
+    int32       posMax;     /**< max. position */
+    u_int16     presses;    /**< push button presses */
+    u_int16     releases;   /**< push button releases */
+    u_int32     peakVel;    /**< max. velocity between two count changes
+                                 [counts/tick, 16.16 fixed, ticks see
+                                 Z73_POS_EXTRAP.tickRate] */
+} Z73_SUMMARY;
+
+/** position checkpoint (Z073_BLK_CHECKPOINT) */
+typedef struct Z73_CHECKPOINT {
+    u_int32     magic;      /**< Z073_CKPT_MAGIC */
+    u_int32     version;    /**< Z073_CKPT_VERSION */
+    int32       pos;        /**< accumulated position */
+    u_int32     inputs;     /**< input levels (Z073_CAP_A/B/PRESS_N) */
+    u_int32     tick;       /**< time taken [OSS ticks] */
+} Z73_CHECKPOINT;
+
+/** trace/capture file header */
+typedef struct {
+    u_int32     magic;      /**< Z073_TRC/CAP/MMIO_MAGIC, in target
+                                 byte order */
+    u_int32     version;    /**< Z073_TRC/CAP/MMIO_VERSION */
+    u_int32     tickRate;   /**< ticks per second */
+    u_int32     recSize;    /**< sizeof(Z73_TRC_REC/CAP_REC/MMIO_REC) */
+} Z73_TRC_HDR;
 /*-----------------------------------------+
 |  PROTOTYPES                              |
 +-----------------------------------------*/
@@ -0,0 +1,104 @@
+/***********************  I n c l u d e  -  F i l e  ***********************/
+/*!
+ *        \file  z73_shm.h
+ *
+ *      \author  Christian.Schuster@men.de
+ *
+ *       \brief  Shared memory layout of the Z73 monitoring daemon
+ *
+ *               The daemon z73_shmd owns the device paths and publishes
+ *               the state and events of each device in one slot of a POSIX
+ *               shared memory segment. Each slot is protected by a seqlock:
+ *               the daemon makes Z73_SHM_SLOT.lock odd while it writes the
+ *               slot, readers copy the data and retry when the lock was
+ *               odd or changed meanwhile. Readers never block the daemon
+ *               and need no system call; use Z73_ShmOpen(),
+ *               Z73_ShmState() and Z73_ShmEvents() of the z73_api library.
+ *               They fail with ERR_LL_DEV_NOTRDY when a slot stays locked
+ *               (daemon died or stopped while writing). A daemon which
+ *               exited between two writes is seen by a stale alive.
+ *
+ *    \switches  (none)
+ *
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2026, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+ /*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _Z73_SHM_H
+#define _Z73_SHM_H
+
+#ifdef __cplusplus
+      extern "C" {
+#endif
+
+/*-----------------------------------------+
+|  DEFINES                                 |
++-----------------------------------------*/
+#define Z73_SHM_NAME_DEF        "/z73_shm"  /**< default segment name */
+#define Z73_SHM_MAGIC           0x5a373353  /**< "Z73S", set when ready */
+#define Z73_SHM_VERSION         1
+#define Z73_SHM_DEV_MAX         8       /**< max. devices (slots) */
+#define Z73_SHM_RING            256     /**< events per slot, power of 2 */
+#define Z73_SHM_NAMELEN         32      /**< max. device name length */
+
+/** memory barriers for the seqlock */
+#define Z73_SHM_WMB()   __atomic_thread_fence( __ATOMIC_RELEASE )
+#define Z73_SHM_RMB()   __atomic_thread_fence( __ATOMIC_ACQUIRE )
+
+/*-----------------------------------------+
+|  TYPEDEFS                                |
++-----------------------------------------*/
+/** current state of a device */
+typedef struct Z73_SHM_STATE {
+    int32       pos;        /**< accumulated position (Z073_CH_POS) */
+    u_int32     status;     /**< last Z073_STATUS word */
+    u_int32     tick;       /**< tick of last event */
+    u_int32     seq;        /**< driver sequence number of last event */
+    u_int32     events;     /**< events published, the newest is
+                                 ring[(events-1) % Z73_SHM_RING] */
+    u_int32     overruns;   /**< button entries dropped by the driver
+                                 (Z073_BTNQ_DROPPED) */
+    int32       error;      /**< error which stopped the device, 0=ok */
+    u_int32     alive;      /**< daemon heartbeat [ms], updated each
+                                 poll cycle */
+} Z73_SHM_STATE;
+
+/** one device */
+typedef struct {
+    volatile u_int32 lock;  /**< seqlock, odd while written */
+    char        device[Z73_SHM_NAMELEN];    /**< device name */
+    Z73_SHM_STATE state;    /**< current state */
+    Z73_EVENT   ring[Z73_SHM_RING];         /**< newest events */
+} Z73_SHM_SLOT;
+
+/** shared memory segment */
+typedef struct Z73_SHM {
+    volatile u_int32 magic; /**< Z73_SHM_MAGIC when initialized */
+    u_int32     version;    /**< Z73_SHM_VERSION */
+    u_int32     numDev;     /**< number of slots used */
+    u_int32     ringSize;   /**< Z73_SHM_RING */
+    u_int32     pid;        /**< process id of the daemon */
+    Z73_SHM_SLOT slot[Z73_SHM_DEV_MAX];
+} Z73_SHM;
+
+#ifdef __cplusplus
+      }
+#endif
+
+#endif /* _Z73_SHM_H */